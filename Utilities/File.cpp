@@ -817,6 +817,72 @@ bool fs::rename(const std::string& from, const std::string& to, bool overwrite)
 #endif
 }
 
+bool fs::create_hard_link(const std::string& from, const std::string& to)
+{
+	const auto device = get_virtual_device(from);
+
+	if (device != get_virtual_device(to) || device) // TODO
+	{
+		fmt::throw_exception("fs::create_hard_link() for virtual devices not implemented.\nFrom: %s\nTo: %s", from, to);
+	}
+
+#ifdef _WIN32
+	if (!CreateHardLinkW(to_wchar(to).get(), to_wchar(from).get(), nullptr))
+	{
+		g_tls_error = to_error(GetLastError());
+		return false;
+	}
+
+	return true;
+#else
+	if (::link(from.c_str(), to.c_str()) != 0)
+	{
+		g_tls_error = to_error(errno);
+		return false;
+	}
+
+	return true;
+#endif
+}
+
+u32 fs::get_link_count(const std::string& path)
+{
+	if (get_virtual_device(path))
+	{
+		g_tls_error = error::unknown;
+		return 0;
+	}
+
+#ifdef _WIN32
+	const auto handle = CreateFileW(to_wchar(path).get(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		g_tls_error = to_error(GetLastError());
+		return 0;
+	}
+
+	BY_HANDLE_FILE_INFORMATION info{};
+	if (!GetFileInformationByHandle(handle, &info))
+	{
+		g_tls_error = to_error(GetLastError());
+		CloseHandle(handle);
+		return 0;
+	}
+
+	CloseHandle(handle);
+	return info.nNumberOfLinks;
+#else
+	struct ::stat file_info;
+	if (::stat(path.c_str(), &file_info) != 0)
+	{
+		g_tls_error = to_error(errno);
+		return 0;
+	}
+
+	return static_cast<u32>(file_info.st_nlink);
+#endif
+}
+
 bool fs::copy_file(const std::string& from, const std::string& to, bool overwrite)
 {
 	const auto device = get_virtual_device(from);
@@ -197,6 +197,12 @@ namespace fs
 	// Copy file contents
 	bool copy_file(const std::string& from, const std::string& to, bool overwrite);
 
+	// Create hard link to existing file
+	bool create_hard_link(const std::string& from, const std::string& to);
+
+	// Get number of hard links to a file (0 on error)
+	u32 get_link_count(const std::string& path);
+
 	// Delete file
 	bool remove_file(const std::string& path);
 
@@ -299,6 +299,12 @@ public:
 	// Exit.
 	[[noreturn]] static void emergency_exit(std::string_view reason);
 
+	// Set function called by emergency_exit() before the current thread is terminated
+	static void set_error_callback(void(*callback)())
+	{
+		g_tls_error_callback = callback;
+	}
+
 	// Get current thread (may be nullptr)
 	static thread_base* get_current()
 	{
@@ -9,9 +9,24 @@
 #include "Emu/VFS.h"
 #include "unpkg.h"
 #include "Loader/PSF.h"
+#include "Utilities/Thread.h"
+#include "Utilities/lockless.h"
+#include "util/sysinfo.hpp"
+#include "util/asm.hpp"
+
+#include <map>
+#include <chrono>
 
 LOG_CHANNEL(pkg_log, "PKG");
 
+// Number of packages being extracted concurrently
+static atomic_t<u32> g_pkg_extractions = 0;
+
+static u64 get_time_us()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 package_reader::package_reader(const std::string& path)
 	: m_path(path)
 {
@@ -688,13 +703,18 @@ package_error package_reader::check_target_app_version() const
 
 fs::file DecryptEDAT(const fs::file& input, const std::string& input_file_name, int mode, u8 *custom_klic, bool verbose = false);
 
-bool package_reader::extract_data(atomic_t<double>& sync)
+bool package_reader::extract_data(atomic_t<double>& sync, usz max_buffer_size)
 {
 	if (!m_is_valid)
 	{
 		return false;
 	}
 
+	const u64 start_time = get_time_us();
+
+	m_stats = {};
+	m_stats.data_size = m_header.data_size;
+
 	// Get full path and create the directory
 	std::string dir = rpcs3::utils::get_hdd0_dir();
 
@@ -743,12 +763,15 @@ bool package_reader::extract_data(atomic_t<double>& sync)
 		return false;
 	}
 
-	usz num_failures = 0;
+	atomic_t<usz> num_failures = 0;
 
 	std::vector<PKGEntry> entries(m_header.file_count);
 
 	std::memcpy(entries.data(), m_buf.get(), entries.size() * sizeof(PKGEntry));
 
+	// Files to extract (directories are created immediately)
+	std::vector<file_job> files;
+
 	for (const auto& entry : entries)
 	{
 		if (entry.name_size > 256)
@@ -794,111 +817,294 @@ bool package_reader::extract_data(atomic_t<double>& sync)
 				break;
 			}
 
-			const bool is_buffered = entry_type == PKG_FILE_ENTRY_SDAT;
-
 			if (entry_type == PKG_FILE_ENTRY_NPDRMEDAT)
 			{
 				pkg_log.todo("NPDRM EDAT!");
 			}
 
-			if (fs::file out = is_buffered ? fs::make_stream<std::vector<u8>>() : fs::file{ path, fs::rewrite })
+			file_job& file = files.emplace_back();
+			file.name = name;
+			file.path = path;
+			file.offset = entry.file_offset;
+			file.size = entry.file_size;
+			file.key = is_psp ? PKG_AES_KEY2 : m_dec_key.data();
+			file.is_buffered = entry_type == PKG_FILE_ENTRY_SDAT;
+			file.did_overwrite = did_overwrite;
+			break;
+		}
+
+		case PKG_FILE_ENTRY_FOLDER:
+		case 0x12:
+		{
+			if (fs::create_dir(path))
+			{
+				pkg_log.notice("Created directory %s", path);
+			}
+			else if (fs::is_dir(path))
 			{
-				bool extract_success = true;
-				for (u64 pos = 0; pos < entry.file_size; pos += BUF_SIZE)
+				pkg_log.warning("Reused existing directory %s", path);
+			}
+			else
+			{
+				num_failures++;
+				pkg_log.error("Failed to create directory %s", path);
+			}
+
+			break;
+		}
+
+		default:
+		{
+			num_failures++;
+			pkg_log.error("Unknown PKG entry type (0x%x) %s", entry.type, name);
+		}
+		}
+	}
+
+	// Extract file data in a pipeline: this thread reads blocks in package order,
+	// decryption workers process them in parallel and writers restore the order per file.
+	// Threads are shared fairly between packages which are being extracted concurrently.
+	const u32 active_count = ++g_pkg_extractions;
+	const u32 decrypt_count = std::clamp<u32>(utils::get_thread_count() / active_count, 1, 16);
+	const u32 writer_count = std::min<u32>(decrypt_count, 2);
+	const u32 max_in_flight = max_buffer_size ? std::max<u32>(::narrow<u32>(max_buffer_size / EXTRACT_BLOCK_SIZE), 2) : decrypt_count * 4;
+
+	const auto decrypt_queues = std::make_unique<lf_queue<std::unique_ptr<extract_block>>[]>(decrypt_count);
+	const auto write_queues = std::make_unique<lf_queue<std::unique_ptr<extract_block>>[]>(writer_count);
+
+	atomic_t<u32> in_flight = 0;
+	atomic_t<u32> decrypt_index = 0;
+	atomic_t<u32> writer_index = 0;
+	atomic_t<bool> cancelled = false;
+	atomic_t<u64> decrypt_time = 0;
+	atomic_t<u64> write_time = 0;
+	u64 read_time = 0;
+
+	// Process queued blocks until the null terminator
+	const auto consume = [](lf_queue<std::unique_ptr<extract_block>>& queue, auto&& func)
+	{
+		while (thread_ctrl::state() != thread_state::aborting)
+		{
+			for (auto&& block : queue.pop_all())
+			{
+				if (!block)
 				{
-					const u64 block_size = std::min<u64>(BUF_SIZE, entry.file_size - pos);
+					return;
+				}
 
-					if (decrypt(entry.file_offset + pos, block_size, is_psp ? PKG_AES_KEY2 : m_dec_key.data()) != block_size)
-					{
-						extract_success = false;
-						pkg_log.error("Failed to extract file %s", path);
-						break;
-					}
+				func(block);
+			}
 
-					if (out.write(m_buf.get(), block_size) != block_size)
-					{
-						extract_success = false;
-						pkg_log.error("Failed to write file %s", path);
-						break;
-					}
+			thread_ctrl::wait_on(queue, nullptr);
+		}
+	};
 
-					if (sync.fetch_add((block_size + 0.0) / m_header.data_size) < 0.)
-					{
-						if (was_null)
-						{
-							pkg_log.error("Package installation cancelled: %s", dir);
-							out.close();
-							fs::remove_all(dir, true);
-							return false;
-						}
+	named_thread_group decrypt_workers("PKG Decrypter ", decrypt_count, [&]()
+	{
+		u64 time = 0;
 
-						// Cannot cancel the installation
-						sync += 1.;
+		consume(decrypt_queues[decrypt_index++], [&](std::unique_ptr<extract_block>& block)
+		{
+			const file_job& file = files[block->file_index];
+
+			const u64 block_start = get_time_us();
+			decrypt_block(file.offset + block->pos, block->data.get(), block->size, file.key);
+			time += get_time_us() - block_start;
+
+			write_queues[block->file_index % writer_count].push(std::move(block));
+		});
+
+		decrypt_time += time;
+	});
+
+	// Finish the file after its last block
+	const auto finish_file = [&](file_job& file)
+	{
+		if (cancelled)
+		{
+			file.out.close();
+			return;
+		}
+
+		if (file.failed)
+		{
+			num_failures++;
+			file.out.close();
+			return;
+		}
+
+		if (file.is_buffered)
+		{
+			file.out = DecryptEDAT(file.out, file.name, 1, reinterpret_cast<u8*>(&m_header.klicensee), true);
+
+			if (!file.out || !fs::write_file(file.path, fs::rewrite, static_cast<fs::container_stream<std::vector<u8>>*>(file.out.release().get())->obj))
+			{
+				num_failures++;
+				pkg_log.error("Failed to create file %s", file.path);
+				return;
+			}
+		}
+
+		if (file.did_overwrite)
+		{
+			pkg_log.warning("Overwritten file %s", file.path);
+		}
+		else
+		{
+			pkg_log.notice("Created file %s", file.path);
+		}
+
+		file.out.close();
+	};
+
+	named_thread_group writers("PKG Writer ", writer_count, [&]()
+	{
+		// Blocks which arrived out of order
+		std::map<u64, std::unique_ptr<extract_block>> pending;
+		u64 next_seq = 0;
+		u64 time = 0;
+
+		consume(write_queues[writer_index++], [&](std::unique_ptr<extract_block>& new_block)
+		{
+			pending.emplace(new_block->seq, std::move(new_block));
+
+			for (auto it = pending.begin(); it != pending.end() && it->first == next_seq; it = pending.erase(it), next_seq++)
+			{
+				const extract_block& block = *it->second;
+				file_job& file = files[block.file_index];
+
+				const u64 block_start = get_time_us();
+
+				if (block.pos == 0 && !cancelled)
+				{
+					file.out = file.is_buffered ? fs::make_stream<std::vector<u8>>() : fs::file{file.path, fs::rewrite};
+
+					if (!file.out)
+					{
+						file.failed = true;
+						pkg_log.error("Failed to create file %s", file.path);
 					}
 				}
 
-				if (is_buffered)
+				if (!file.failed && !cancelled)
 				{
-					out = DecryptEDAT(out, name, 1, reinterpret_cast<u8*>(&m_header.klicensee), true);
-					if (!out || !fs::write_file(path, fs::rewrite, static_cast<fs::container_stream<std::vector<u8>>*>(out.release().get())->obj))
+					if (block.read_failed)
+					{
+						file.failed = true;
+						pkg_log.error("Failed to extract file %s", file.path);
+					}
+					else if (file.out.write(block.data.get(), block.size) != block.size)
 					{
-						num_failures++;
-						pkg_log.error("Failed to create file %s", path);
-						break;
+						file.failed = true;
+						pkg_log.error("Failed to write file %s", file.path);
 					}
 				}
 
-				if (extract_success)
+				if (sync.fetch_add((block.size + 0.0) / m_header.data_size) < 0.)
 				{
-					if (did_overwrite)
+					if (was_null)
 					{
-						pkg_log.warning("Overwritten file %s", path);
+						cancelled = true;
 					}
 					else
 					{
-						pkg_log.notice("Created file %s", path);
+						// Cannot cancel the installation
+						sync.fetch_op([](double& value)
+						{
+							if (value < 0.)
+							{
+								value += 1.;
+							}
+						});
 					}
 				}
-				else
+
+				if (block.pos + block.size >= file.size)
 				{
-					num_failures++;
+					finish_file(file);
 				}
+
+				time += get_time_us() - block_start;
+
+				in_flight--;
+				in_flight.notify_one();
 			}
-			else
-			{
-				num_failures++;
-				pkg_log.error("Failed to create file %s", path);
-			}
+		});
 
-			break;
-		}
+		write_time += time;
+	});
 
-		case PKG_FILE_ENTRY_FOLDER:
-		case 0x12:
+	// Per-writer sequence numbers
+	std::vector<u64> write_seq(writer_count);
+	u32 decrypt_seq = 0;
+
+	for (usz i = 0; i < files.size() && !cancelled; i++)
+	{
+		const file_job& file = files[i];
+
+		// Empty files produce a single empty block
+		for (u64 pos = 0; !cancelled;)
 		{
-			if (fs::create_dir(path))
+			const u64 size = std::min<u64>(EXTRACT_BLOCK_SIZE, file.size - pos);
+
+			// Limit memory usage
+			for (u32 count = in_flight; count >= max_in_flight; count = in_flight)
 			{
-				pkg_log.notice("Created directory %s", path);
+				in_flight.wait(count);
 			}
-			else if (fs::is_dir(path))
-			{
-				pkg_log.warning("Reused existing directory %s", path);
-			}
-			else
+
+			auto block = std::make_unique<extract_block>();
+			block->file_index = i;
+			block->pos = pos;
+			block->size = size;
+			block->seq = write_seq[i % writer_count]++;
+			block->data.reset(new u128[utils::aligned_div<u64>(size, sizeof(u128))]);
+
+			const u64 read_start = get_time_us();
+			archive_seek(m_header.data_offset + file.offset + pos);
+			block->read_failed = archive_read(block->data.get(), size) != size;
+			read_time += get_time_us() - read_start;
+
+			in_flight++;
+			decrypt_queues[decrypt_seq++ % decrypt_count].push(std::move(block));
+
+			pos += size;
+
+			if (pos >= file.size)
 			{
-				num_failures++;
-				pkg_log.error("Failed to create directory %s", path);
+				break;
 			}
-
-			break;
 		}
+	}
 
-		default:
-		{
-			num_failures++;
-			pkg_log.error("Unknown PKG entry type (0x%x) %s", entry.type, name);
-		}
-		}
+	// Stop decryption first so that writers receive all blocks before their terminator
+	for (u32 i = 0; i < decrypt_count; i++)
+	{
+		decrypt_queues[i].push(nullptr);
+	}
+
+	decrypt_workers.join();
+
+	for (u32 i = 0; i < writer_count; i++)
+	{
+		write_queues[i].push(nullptr);
+	}
+
+	writers.join();
+
+	g_pkg_extractions--;
+
+	m_stats.total_us = get_time_us() - start_time;
+	m_stats.read_us = read_time;
+	m_stats.decrypt_us = decrypt_time;
+	m_stats.write_us = write_time;
+
+	if (cancelled)
+	{
+		pkg_log.error("Package installation cancelled: %s", dir);
+		files.clear();
+		fs::remove_all(dir, true);
+		return false;
 	}
 
 	if (num_failures == 0)
@@ -942,8 +1148,16 @@ u64 package_reader::decrypt(u64 offset, u64 size, const uchar* key)
 	// Read the data and set available size
 	const u64 read = archive_read(m_buf.get(), size);
 
+	decrypt_block(offset, m_buf.get(), read, key);
+
+	// Return the amount of data written in buf
+	return read;
+};
+
+void package_reader::decrypt_block(u64 offset, u128* data, u64 size, const uchar* key) const
+{
 	// Get block count
-	const u64 blocks = (read + 15) / 16;
+	const u64 blocks = (size + 15) / 16;
 
 	if (m_header.pkg_type == PKG_RELEASE_TYPE_DEBUG)
 	{
@@ -969,7 +1183,7 @@ u64 package_reader::decrypt(u64 offset, u64 size, const uchar* key)
 
 			sha1(reinterpret_cast<const u8*>(input), sizeof(input), hash.data);
 
-			m_buf[i] ^= hash._v128;
+			data[i] ^= hash._v128;
 		}
 	}
 	else if (m_header.pkg_type == PKG_RELEASE_TYPE_RELEASE)
@@ -989,14 +1203,11 @@ u64 package_reader::decrypt(u64 offset, u64 size, const uchar* key)
 
 			aes_crypt_ecb(&ctx, AES_ENCRYPT, reinterpret_cast<const u8*>(&input), reinterpret_cast<u8*>(&key));
 
-			m_buf[i] ^= key;
+			data[i] ^= key;
 		}
 	}
 	else
 	{
 		pkg_log.error("Unknown release type (0x%x)", m_header.pkg_type);
 	}
-
-	// Return the amount of data written in buf
-	return read;
-};
+}
@@ -304,13 +304,24 @@ enum class package_error
 class package_reader
 {
 public:
+	// Time spent in each stage of extract_data (decrypt and write are summed over threads)
+	struct extract_stats
+	{
+		u64 data_size = 0;
+		u64 total_us = 0;
+		u64 read_us = 0;
+		u64 decrypt_us = 0;
+		u64 write_us = 0;
+	};
+
 	package_reader(const std::string& path);
 	~package_reader();
 
 	bool is_valid() const { return m_is_valid; }
 	package_error check_target_app_version() const;
-	bool extract_data(atomic_t<double>& sync);
+	bool extract_data(atomic_t<double>& sync, usz max_buffer_size = 0);
 	psf::registry get_psf() const { return m_psf; }
+	const extract_stats& get_extract_stats() const { return m_stats; }
 
 private:
 	bool read_header();
@@ -320,8 +331,35 @@ private:
 	void archive_seek(const s64 new_offset, const fs::seek_mode damode = fs::seek_set);
 	u64 archive_read(void* data_ptr, const u64 num_bytes);
 	u64 decrypt(u64 offset, u64 size, const uchar* key);
+	void decrypt_block(u64 offset, u128* data, u64 size, const uchar* key) const;
+
+	// File being extracted
+	struct file_job
+	{
+		std::string name;
+		std::string path;
+		u64 offset = 0;
+		u64 size = 0;
+		const uchar* key = nullptr;
+		bool is_buffered = false;
+		bool did_overwrite = false;
+		bool failed = false;
+		fs::file out;
+	};
+
+	// Block of file data in the extraction pipeline
+	struct extract_block
+	{
+		usz file_index = 0;
+		u64 pos = 0; // Position in file
+		u64 size = 0;
+		u64 seq = 0; // Writer sequence number
+		bool read_failed = false;
+		std::unique_ptr<u128[]> data;
+	};
 
 	const usz BUF_SIZE = 8192 * 1024; // 8 MB
+	const usz EXTRACT_BLOCK_SIZE = 1024 * 1024; // 1 MB
 
 	bool m_is_valid = false;
 
@@ -334,4 +372,5 @@ private:
 	PKGHeader m_header{};
 	PKGMetaData m_metadata{};
 	psf::registry m_psf{};
+	extract_stats m_stats{};
 };
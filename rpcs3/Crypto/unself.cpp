@@ -5,10 +5,46 @@
 #include "Emu/VFS.h"
 #include "Emu/System.h"
 #include "Emu/system_utils.hpp"
+#include "Emu/system_config.h"
+#include "Emu/cache_utils.hpp"
+
+#include "Utilities/Thread.h"
+#include "util/sysinfo.hpp"
 
 #include <algorithm>
 #include <zlib.h>
 
+#include "xxhash.h"
+
+// Run func(i) for every section, in parallel if there is enough data to make it worth it
+template <typename F>
+static void for_each_section(u32 count, u64 data_size, F&& func)
+{
+	const u32 threads = data_size >= 0x40'0000 ? std::min<u32>(utils::get_thread_count(), count) : 1;
+
+	if (threads <= 1)
+	{
+		for (u32 i = 0; i < count; i++)
+		{
+			func(i);
+		}
+
+		return;
+	}
+
+	atomic_t<u32> next = 0;
+
+	named_thread_group workers("SELF Decrypter ", threads, [&]()
+	{
+		for (u32 i = next++; i < count; i = next++)
+		{
+			func(i);
+		}
+	});
+
+	workers.join();
+}
+
 inline u8 Read8(const fs::file& f)
 {
 	u8 ret;
@@ -1213,11 +1249,13 @@ bool SELFDecrypter::LoadMetadata(u8* klic_key)
 
 bool SELFDecrypter::DecryptData()
 {
-	aes_context aes;
+	std::vector<u32> offsets(meta_hdr.section_count);
 
 	// Calculate the total data size.
 	for (unsigned int i = 0; i < meta_hdr.section_count; i++)
 	{
+		offsets[i] = data_buf_length;
+
 		if (meta_shdr[i].encrypted == 3)
 		{
 			if ((meta_shdr[i].key_idx <= meta_hdr.key_count - 1) && (meta_shdr[i].iv_idx <= meta_hdr.key_count))
@@ -1228,51 +1266,94 @@ bool SELFDecrypter::DecryptData()
 	// Allocate a buffer to store decrypted data.
 	data_buf = std::make_unique<u8[]>(data_buf_length);
 
-	// Set initial offset.
-	u32 data_buf_offset = 0;
+	const auto is_valid = [&](u32 i)
+	{
+		return meta_shdr[i].encrypted == 3 && (meta_shdr[i].key_idx <= meta_hdr.key_count - 1) && (meta_shdr[i].iv_idx <= meta_hdr.key_count);
+	};
 
-	// Parse the metadata section headers to find the offsets of encrypted data.
+	// Read the encrypted data of all sections first (sequentially).
 	for (unsigned int i = 0; i < meta_hdr.section_count; i++)
 	{
+		if (is_valid(i))
+		{
+			self_f.seek(meta_shdr[i].data_offset);
+			self_f.read(data_buf.get() + offsets[i], meta_shdr[i].data_size);
+		}
+	}
+
+	// Decrypt the sections in place.
+	for_each_section(meta_hdr.section_count, data_buf_length, [&](u32 i)
+	{
+		if (!is_valid(i))
+		{
+			return;
+		}
+
+		aes_context aes;
 		usz ctr_nc_off = 0;
-		u8 ctr_stream_block[0x10];
+		u8 ctr_stream_block[0x10]{};
 		u8 data_key[0x10];
 		u8 data_iv[0x10];
 
-		// Check if this is an encrypted section.
-		if (meta_shdr[i].encrypted == 3)
-		{
-			// Make sure the key and iv are not out of boundaries.
-			if((meta_shdr[i].key_idx <= meta_hdr.key_count - 1) && (meta_shdr[i].iv_idx <= meta_hdr.key_count))
-			{
-				// Get the key and iv from the previously stored key buffer.
-				memcpy(data_key, data_keys.get() + meta_shdr[i].key_idx * 0x10, 0x10);
-				memcpy(data_iv, data_keys.get() + meta_shdr[i].iv_idx * 0x10, 0x10);
+		// Get the key and iv from the previously stored key buffer.
+		memcpy(data_key, data_keys.get() + meta_shdr[i].key_idx * 0x10, 0x10);
+		memcpy(data_iv, data_keys.get() + meta_shdr[i].iv_idx * 0x10, 0x10);
 
-				// Allocate a buffer to hold the data.
-				auto buf = std::make_unique<u8[]>(meta_shdr[i].data_size);
+		// Perform AES-CTR encryption on the data blocks.
+		u8* const data = data_buf.get() + offsets[i];
+		aes_setkey_enc(&aes, data_key, 128);
+		aes_crypt_ctr(&aes, meta_shdr[i].data_size, &ctr_nc_off, data_iv, ctr_stream_block, data, data);
+	});
 
-				// Seek to the section data offset and read the encrypted data.
-				self_f.seek(meta_shdr[i].data_offset);
-				self_f.read(buf.get(), meta_shdr[i].data_size);
+	return true;
+}
 
-				// Zero out our ctr nonce.
-				memset(ctr_stream_block, 0, sizeof(ctr_stream_block));
+std::vector<std::vector<u8>> SELFDecrypter::DecompressSections(const std::vector<u64>& sizes) const
+{
+	std::vector<std::vector<u8>> result(meta_hdr.section_count);
+	std::vector<u32> offsets(meta_hdr.section_count);
 
-				// Perform AES-CTR encryption on the data blocks.
-				aes_setkey_enc(&aes, data_key, 128);
-				aes_crypt_ctr(&aes, meta_shdr[i].data_size, &ctr_nc_off, data_iv, ctr_stream_block, buf.get(), buf.get());
+	u64 total_size = 0;
 
-				// Copy the decrypted data.
-				memcpy(data_buf.get() + data_buf_offset, buf.get(), meta_shdr[i].data_size);
+	// Find section data (same layout as WriteElf)
+	for (u32 i = 0, data_buf_offset = 0; i < meta_hdr.section_count; i++)
+	{
+		offsets[i] = data_buf_offset;
 
-				// Advance the buffer's offset.
-				data_buf_offset += ::narrow<u32>(meta_shdr[i].data_size);
-			}
+		if (meta_shdr[i].type == 2)
+		{
+			data_buf_offset += ::narrow<u32>(meta_shdr[i].data_size);
 		}
+
+		total_size += sizes[i];
 	}
 
-	return true;
+	for_each_section(meta_hdr.section_count, total_size, [&](u32 i)
+	{
+		if (!sizes[i])
+		{
+			return;
+		}
+
+		result[i].resize(sizes[i]);
+
+		uLongf decomp_buf_length = ::narrow<uLongf>(sizes[i]);
+
+		// Use zlib uncompress on the section data
+		// decomp_buf_length changes inside the call to uncompress
+		const int rv = uncompress(result[i].data(), &decomp_buf_length, data_buf.get() + offsets[i], data_buf_length - std::min(offsets[i], data_buf_length));
+
+		// Check for errors (TODO: Probably safe to remove this once these changes have passed testing.)
+		switch (rv)
+		{
+		case Z_MEM_ERROR: self_log.error("MakeELF encountered a Z_MEM_ERROR!"); break;
+		case Z_BUF_ERROR: self_log.error("MakeELF encountered a Z_BUF_ERROR!"); break;
+		case Z_DATA_ERROR: self_log.error("MakeELF encountered a Z_DATA_ERROR!"); break;
+		default: break;
+		}
+	});
+
+	return result;
 }
 
 fs::file SELFDecrypter::MakeElf(bool isElf32)
@@ -1409,6 +1490,44 @@ static bool CheckDebugSelf(fs::file& s)
 	return false;
 }
 
+// Get location of the decrypted image in the cache (empty if disabled)
+// Keyed by file size, SCE headers and klic: the headers include the encrypted section digests, so the data itself is not hashed
+static std::string get_self_cache_path(const fs::file& self, const u8* klic_key)
+{
+	if (!g_cfg.core.self_cache)
+	{
+		return {};
+	}
+
+	const u64 file_size = self.size();
+
+	SceHeader sce_hdr{};
+	self.seek(0);
+	sce_hdr.Load(self);
+
+	// Limit the amount read for broken headers
+	std::vector<u8> headers(std::min<u64>({sce_hdr.se_hsize, file_size, 0x10'0000}));
+
+	if (self.seek(0), self.read(headers.data(), headers.size()) != headers.size())
+	{
+		return {};
+	}
+
+	const std::unique_ptr<XXH64_state_t, decltype(&XXH64_freeState)> state(XXH64_createState(), &XXH64_freeState);
+
+	// Seed is the cache format version
+	XXH64_reset(state.get(), 2);
+	XXH64_update(state.get(), &file_size, sizeof(file_size));
+	XXH64_update(state.get(), headers.data(), headers.size());
+
+	if (klic_key)
+	{
+		XXH64_update(state.get(), klic_key, 0x10);
+	}
+
+	return fmt::format("%s%016llx-%x.elf", rpcs3::cache::get_self_cache(), XXH64_digest(state.get()), file_size);
+}
+
 fs::file decrypt_self(fs::file elf_or_self, u8* klic_key, SelfAdditionalInfo* out_info)
 {
 	if (out_info)
@@ -1439,6 +1558,19 @@ fs::file decrypt_self(fs::file elf_or_self, u8* klic_key, SelfAdditionalInfo* ou
 			return fs::file{};
 		}
 
+		const std::string cache_path = get_self_cache_path(elf_or_self, klic_key);
+
+		// Skip decryption if the image is cached
+		if (fs::file cached; !cache_path.empty() && cached.open(cache_path) && cached.size() >= 4 && cached.read<u32>() == "\177ELF"_u32)
+		{
+			self_log.notice("Loaded decrypted SELF from cache (%s)", cache_path);
+
+			// Mark as recently used for limit_cache_size
+			const s64 now = std::time(nullptr);
+			fs::utime(cache_path, now, now);
+			return fs::make_stream(cached.to_vector<u8>());
+		}
+
 		// Load and decrypt the SELF file metadata.
 		if (!self_dec.LoadMetadata(klic_key))
 		{
@@ -1454,7 +1586,19 @@ fs::file decrypt_self(fs::file elf_or_self, u8* klic_key, SelfAdditionalInfo* ou
 		}
 
 		// Make a new ELF file from this SELF.
-		return self_dec.MakeElf(isElf32);
+		fs::file elf = self_dec.MakeElf(isElf32);
+
+		if (!cache_path.empty())
+		{
+			fs::pending_file file(cache_path);
+
+			if (!fs::create_path(fs::get_parent_dir(cache_path)) || !file.file || !file.file.write(elf.to_vector<u8>()) || !file.commit(false))
+			{
+				self_log.error("Failed to cache decrypted SELF (%s): %s", cache_path, fs::g_tls_error);
+			}
+		}
+
+		return elf;
 	}
 
 	return elf_or_self;
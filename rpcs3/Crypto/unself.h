@@ -420,6 +420,9 @@ public:
 	static bool GetKeyFromRap(const char *content_id, u8 *npdrm_key);
 
 private:
+	// Decompress compressed PHDR sections of data_buf (sizes are decompressed sizes, zero for other sections)
+	std::vector<std::vector<u8>> DecompressSections(const std::vector<u64>& sizes) const;
+
 	template<typename EHdr, typename SHdr, typename PHdr>
 	void WriteElf(fs::file& e, EHdr ehdr, SHdr shdr, PHdr phdr)
 	{
@@ -435,46 +438,33 @@ private:
 			WritePhdr(e, phdr[i]);
 		}
 
+		// Decompress PHDR sections (in parallel)
+		std::vector<u64> sizes(meta_hdr.section_count);
+
+		for (unsigned int i = 0; i < meta_hdr.section_count; i++)
+		{
+			if (meta_shdr[i].type == 2 && meta_shdr[i].compressed == 2)
+			{
+				sizes[i] = phdr[meta_shdr[i].program_idx].p_filesz;
+			}
+		}
+
+		const auto decompressed = DecompressSections(sizes);
+
 		for (unsigned int i = 0; i < meta_hdr.section_count; i++)
 		{
 			// PHDR type.
 			if (meta_shdr[i].type == 2)
 			{
-				// Decompress if necessary.
+				// Seek to the program header data offset and write the data.
+				e.seek(phdr[meta_shdr[i].program_idx].p_offset);
+
 				if (meta_shdr[i].compressed == 2)
 				{
-					const auto filesz = phdr[meta_shdr[i].program_idx].p_filesz;
-
-					// Create a pointer to a buffer for decompression.
-					std::unique_ptr<u8[]> decomp_buf(new u8[filesz]);
-
-					// Create a buffer separate from data_buf to uncompress.
-					std::unique_ptr<u8[]> zlib_buf(new u8[data_buf_length]);
-					memcpy(zlib_buf.get(), data_buf.get(), data_buf_length);
-
-					uLongf decomp_buf_length = ::narrow<uLongf>(filesz);
-
-					// Use zlib uncompress on the new buffer.
-					// decomp_buf_length changes inside the call to uncompress
-					const int rv = uncompress(decomp_buf.get(), &decomp_buf_length, zlib_buf.get() + data_buf_offset, data_buf_length);
-
-					// Check for errors (TODO: Probably safe to remove this once these changes have passed testing.)
-					switch (rv)
-					{
-					case Z_MEM_ERROR: self_log.error("MakeELF encountered a Z_MEM_ERROR!"); break;
-					case Z_BUF_ERROR: self_log.error("MakeELF encountered a Z_BUF_ERROR!"); break;
-					case Z_DATA_ERROR: self_log.error("MakeELF encountered a Z_DATA_ERROR!"); break;
-					default: break;
-					}
-
-					// Seek to the program header data offset and write the data.
-					e.seek(phdr[meta_shdr[i].program_idx].p_offset);
-					e.write(decomp_buf.get(), filesz);
+					e.write(decompressed[i]);
 				}
 				else
 				{
-					// Seek to the program header data offset and write the data.
-					e.seek(phdr[meta_shdr[i].program_idx].p_offset);
 					e.write(data_buf.get() + data_buf_offset, meta_shdr[i].data_size);
 				}
 
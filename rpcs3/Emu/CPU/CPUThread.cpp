@@ -11,6 +11,7 @@
 #include "Emu/Cell/SPUThread.h"
 #include "Emu/RSX/RSXThread.h"
 #include "Emu/perf_meter.hpp"
+#include "Emu/perf_trace.hpp"
 
 #include "util/asm.hpp"
 #include <thread>
@@ -644,6 +645,9 @@ bool cpu_thread::check_state() noexcept
 	bool cpu_can_stop = true;
 	bool escape, retval;
 
+	// Timeline event recorded while the thread is held
+	bool traced = false;
+
 	while (true)
 	{
 		// Process all flags in a single atomic op
@@ -769,6 +773,12 @@ bool cpu_thread::check_state() noexcept
 
 		if (escape)
 		{
+			if (traced) [[unlikely]]
+			{
+				perf_trace::record(perf_trace::event_type::end, nullptr, 0);
+				traced = false;
+			}
+
 			if (s_tls_thread_slot == umax && !retval)
 			{
 				// Restore thread in the suspend list
@@ -798,6 +808,13 @@ bool cpu_thread::check_state() noexcept
 			return retval;
 		}
 
+		if (!traced && g_cfg.core.perf_trace) [[unlikely]]
+		{
+			const char* reason = state0 & cpu_flag::suspend ? "Suspended" : state0 & cpu_flag::memory ? "Memory lock" : state0 & cpu_flag::pause ? "Paused" : "Debug pause";
+			perf_trace::record(perf_trace::event_type::begin, reason, id);
+			traced = true;
+		}
+
 		if (cpu_can_stop && !cpu_sleep_called && state0 & cpu_flag::suspend)
 		{
 			cpu_sleep();
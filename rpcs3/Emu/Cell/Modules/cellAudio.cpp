@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "Emu/System.h"
+#include "Emu/perf_trace.hpp"
 #include "Emu/Cell/PPUModule.h"
 
 #include "Emu/Cell/lv2/sys_process.h"
@@ -952,6 +953,8 @@ void cell_audio_thread::operator()()
 			}
 		}
 
+		perf_trace::scope trace("cellAudio mix");
+
 		// Mix
 		float* buf = ringbuffer->get_current_buffer();
 
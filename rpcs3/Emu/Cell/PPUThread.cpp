@@ -7,12 +7,14 @@
 #include "Loader/ELF.h"
 #include "Loader/mself.hpp"
 #include "Emu/perf_meter.hpp"
+#include "Emu/perf_trace.hpp"
 #include "Emu/Memory/vm_reservation.h"
 #include "Emu/Memory/vm_locking.h"
 #include "Emu/RSX/RSXThread.h"
 #include "Emu/VFS.h"
 #include "Emu/system_progress.hpp"
 #include "Emu/system_utils.hpp"
+#include "Emu/cache_utils.hpp"
 #include "PPUThread.h"
 #include "PPUInterpreter.h"
 #include "PPUAnalyser.h"
@@ -1578,6 +1580,8 @@ ppu_thread::~ppu_thread()
 {
 	perf_log.notice("Perf stats for STCX reload: successs %u, failure %u", last_succ, last_fail);
 	perf_log.notice("Perf stats for instructions: total %u", exec_bytes / 4);
+
+	vm::reservation_add_failures(rsrv_failures);
 }
 
 ppu_thread::ppu_thread(const ppu_thread_params& param, std::string_view name, u32 prio, int detached)
@@ -2237,7 +2241,7 @@ const auto ppu_stcx_accurate_tx = build_function_asm<u64(*)(u32 raddr, u64 rtime
 	c.and_(x86::rbp, -128);
 	c.prefetchw(x86::byte_ptr(x86::rbp, 0));
 	c.prefetchw(x86::byte_ptr(x86::rbp, 64));
-	c.movzx(args[0].r32(), args[0].r16());
+	c.and_(args[0].r32(), vm::rsrv_table_mask | 127);
 	c.shr(args[0].r32(), 1);
 	c.lea(x86::r11, x86::qword_ptr(reinterpret_cast<u64>(+vm::g_reservations), args[0]));
 	c.and_(x86::r11, -128 / 2);
@@ -2458,8 +2462,28 @@ static bool ppu_store_reservation(ppu_thread& ppu, u32 addr, u64 reg_value)
 		}
 	}
 
-	if (old_data != data || rtime != (res & -128))
+	if (old_data != data)
+	{
+		ppu.rsrv_failures.conflicts++;
+		return false;
+	}
+
+	if (rtime != (res & -128))
 	{
+		if (!ppu.use_full_rdata)
+		{
+			// Only the reserved doubleword is known without full reservation data
+			ppu.rsrv_failures.unknown++;
+		}
+		else if (cmp_rdata(ppu.rdata, vm::_ref<spu_rdata_t>(addr & -128)))
+		{
+			ppu.rsrv_failures.collisions++;
+		}
+		else
+		{
+			ppu.rsrv_failures.conflicts++;
+		}
+
 		return false;
 	}
 
@@ -2855,7 +2879,8 @@ extern void ppu_precompile(std::vector<std::string>& dir_queue, std::vector<ppu_
 	const bool had_ovl = !vm::map(0x3000'0000, 0x1000'0000, 0x202).operator bool();
 	const u32 ppc_seg = std::exchange(g_ps3_process_info.ppc_seg, 0x3);
 
-	std::vector<std::pair<std::string, u64>> file_queue;
+	// Path, offset and size of modules
+	std::vector<std::tuple<std::string, u64, u64>> file_queue;
 	file_queue.reserve(2000);
 
 	// Find all .sprx files recursively
@@ -2934,7 +2959,7 @@ extern void ppu_precompile(std::vector<std::string>& dir_queue, std::vector<ppu_
 				}
 
 				// Get full path
-				file_queue.emplace_back(dir_queue[i] + entry.name, 0);
+				file_queue.emplace_back(dir_queue[i] + entry.name, 0, entry.size);
 				continue;
 			}
 
@@ -2942,7 +2967,7 @@ extern void ppu_precompile(std::vector<std::string>& dir_queue, std::vector<ppu_
 			if (upper.ends_with(".SELF"))
 			{
 				// Get full path
-				file_queue.emplace_back(dir_queue[i] + entry.name,  0);
+				file_queue.emplace_back(dir_queue[i] + entry.name, 0, entry.size);
 				continue;
 			}
 
@@ -2968,14 +2993,14 @@ extern void ppu_precompile(std::vector<std::string>& dir_queue, std::vector<ppu_
 								if (upper.ends_with(".SPRX"))
 								{
 									// .sprx inside .mself found
-									file_queue.emplace_back(dir_queue[i] + entry.name, rec.off);
+									file_queue.emplace_back(dir_queue[i] + entry.name, rec.off, rec.size);
 									continue;
 								}
 
 								if (upper.ends_with(".SELF"))
 								{
 									// .self inside .mself found
-									file_queue.emplace_back(dir_queue[i] + entry.name, rec.off);
+									file_queue.emplace_back(dir_queue[i] + entry.name, rec.off, rec.size);
 									continue;
 								}
 							}
@@ -2991,6 +3016,12 @@ extern void ppu_precompile(std::vector<std::string>& dir_queue, std::vector<ppu_
 		}
 	}
 
+	// Start with the largest modules, so they don't end up on the critical path
+	std::stable_sort(file_queue.begin(), file_queue.end(), [](const auto& a, const auto& b)
+	{
+		return std::get<2>(a) > std::get<2>(b);
+	});
+
 	g_progr_ftotal += file_queue.size();
 	scoped_progress_dialog progr = "Compiling PPU modules...";
 
@@ -3013,7 +3044,8 @@ extern void ppu_precompile(std::vector<std::string>& dir_queue, std::vector<ppu_
 				continue;
 			}
 
-			auto [path, offset] = std::as_const(file_queue)[func_i];
+			std::string path = std::get<0>(file_queue[func_i]);
+			const u64 offset = std::get<1>(file_queue[func_i]);
 
 			ppu_log.notice("Trying to load: %s", path);
 
@@ -3246,6 +3278,152 @@ struct ppu_toc_manager
 	shared_mutex mutex;
 };
 
+// Compilation jobs of all modules being compiled concurrently
+// Workers take the most expensive job first, regardless of the module it belongs to
+struct ppu_compile_scheduler
+{
+	struct module_state
+	{
+		std::string name;
+		u32 total = 0; // Number of parts
+		atomic_t<u32> done = 0;
+		u64 total_cost = 0;
+		atomic_t<u64> done_cost = 0;
+		atomic_t<u32> pending = 0; // Parts not compiled
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		// Estimated time left in seconds (based on compiled instructions so far)
+		u64 get_eta() const
+		{
+			const u64 cost = done_cost;
+
+			if (!cost)
+			{
+				return umax;
+			}
+
+			const u64 elapsed = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start).count();
+			return (total_cost - std::min(cost, total_cost)) * elapsed / cost;
+		}
+	};
+
+	struct job
+	{
+		std::shared_ptr<module_state> module;
+		std::function<void()> func;
+		u64 cost;
+	};
+
+	shared_mutex mutex;
+
+	// Jobs by cost
+	std::multimap<u64, job, std::greater<u64>> jobs;
+
+	// Modules with parts not compiled
+	std::vector<std::shared_ptr<module_state>> modules;
+
+	// Estimate compilation cost of a module part (instruction count with a fixed overhead per function)
+	static u64 get_cost(const ppu_module& part)
+	{
+		u64 cost = 0;
+
+		for (const auto& func : part.funcs)
+		{
+			cost += func.size / 4 + 32;
+		}
+
+		return cost;
+	}
+
+	void submit(const std::shared_ptr<module_state>& module, std::vector<std::pair<u64, std::function<void()>>>&& funcs)
+	{
+		module->total = ::size32(funcs);
+		module->pending = module->total;
+
+		std::lock_guard lock(mutex);
+
+		for (auto& [cost, func] : funcs)
+		{
+			module->total_cost += cost;
+			jobs.emplace(cost, job{module, std::move(func), cost});
+		}
+
+		modules.emplace_back(module);
+	}
+
+	// Execute the most expensive job, returns false if there are none left
+	bool run_one()
+	{
+		job _job;
+		{
+			std::lock_guard lock(mutex);
+
+			if (jobs.empty())
+			{
+				return false;
+			}
+
+			_job = std::move(jobs.begin()->second);
+			jobs.erase(jobs.begin());
+		}
+
+		module_state& _module = *_job.module;
+
+		_job.func();
+
+		_module.done_cost += _job.cost;
+		const u32 done = ++_module.done;
+
+		if (const u64 eta = _module.get_eta(); eta != umax && done < _module.total)
+		{
+			ppu_log.notice("LLVM: %s: %u/%u parts compiled (ETA: %us)", _module.name, done, _module.total, eta);
+		}
+
+		if (_module.pending-- == 1)
+		{
+			{
+				std::lock_guard lock(mutex);
+				std::erase(modules, _job.module);
+			}
+
+			_module.pending.notify_all();
+		}
+
+		return true;
+	}
+
+	// Get compilation progress of every module being compiled, one line per module
+	std::string get_progress()
+	{
+		std::string result;
+
+		reader_lock lock(mutex);
+
+		for (const auto& module : modules)
+		{
+			fmt::append(result, "%s%s: %u/%u", result.empty() ? "" : "\n", module->name, module->done.load(), module->total);
+
+			if (const u64 eta = module->get_eta(); eta != umax)
+			{
+				fmt::append(result, " (ETA: %us)", eta);
+			}
+		}
+
+		return result;
+	}
+};
+
+// Per-module compilation progress for the progress dialog
+std::string ppu_get_compile_progress()
+{
+	if (auto sched = g_fxo->try_get<ppu_compile_scheduler>())
+	{
+		return sched->get_progress();
+	}
+
+	return {};
+}
+
 bool ppu_initialize(const ppu_module& info, bool check_only)
 {
 	if (g_cfg.core.ppu_decoder != ppu_decoder_type::llvm)
@@ -3377,9 +3555,6 @@ bool ppu_initialize(const ppu_module& info, bool check_only)
 	// Info to load to main JIT instance (true - compiled)
 	std::vector<std::pair<std::string, bool>> link_workload;
 
-	// Sync variable to acquire workloads
-	atomic_t<u32> work_cv = 0;
-
 	bool compiled_new = false;
 
 	bool has_mfvscr = false;
@@ -3648,8 +3823,8 @@ bool ppu_initialize(const ppu_module& info, bool check_only)
 			link_workload.emplace_back(obj_name, false);
 		}
 
-		// Check object file
-		if (jit_compiler::check(cache_path + obj_name))
+		// Check object file (try to obtain it from the shared object store first, the name is content-addressed)
+		if (jit_compiler::check(cache_path + obj_name) || (rpcs3::cache::get_shared_object(cache_path, obj_name + ".gz") && jit_compiler::check(cache_path + obj_name)))
 		{
 			if (!jit && !check_only)
 			{
@@ -3704,39 +3879,73 @@ bool ppu_initialize(const ppu_module& info, bool check_only)
 		// Prevent watchdog thread from terminating
 		g_watchdog_hold_ctr++;
 
-		named_thread_group threads(fmt::format("PPUW.%u.", ++g_fxo->get<thread_index_allocator>().index), thread_count, [&]()
+		auto& sched = g_fxo->get<ppu_compile_scheduler>();
+
+		const auto compile_state = std::make_shared<ppu_compile_scheduler::module_state>();
+		compile_state->name = info.name;
+
+		if (!workload.empty())
 		{
-			// Set low priority
-			thread_ctrl::scoped_priority low_prio(-1);
+			std::vector<std::pair<u64, std::function<void()>>> jobs;
+			jobs.reserve(workload.size());
 
-#ifdef __APPLE__
-			pthread_jit_write_protect_np(false);
-#endif
-			for (u32 i = work_cv++; i < workload.size(); i = work_cv++, g_progr_pdone++)
+			for (const auto& entry : std::as_const(workload))
 			{
-				if (Emu.IsStopped())
+				jobs.emplace_back(ppu_compile_scheduler::get_cost(entry.second), [&]()
 				{
-					continue;
-				}
+					const auto& [obj_name, part] = entry;
+
+					if (Emu.IsStopped())
+					{
+						g_progr_pdone++;
+						return;
+					}
 
-				// Keep allocating workload
-				const auto& [obj_name, part] = std::as_const(workload)[i];
+					// Allocate "core"
+					std::lock_guard jlock(g_fxo->get<jit_core_allocator>().sem);
 
-				// Allocate "core"
-				std::lock_guard jlock(g_fxo->get<jit_core_allocator>().sem);
+					ppu_log.warning("LLVM: Compiling module %s%s", cache_path, obj_name);
 
-				ppu_log.warning("LLVM: Compiling module %s%s", cache_path, obj_name);
+					perf_trace::scope trace("PPU LLVM compile");
 
-				// Use another JIT instance
-				jit_compiler jit2({}, g_cfg.core.llvm_cpu, 0x1);
-				ppu_initialize2(jit2, part, cache_path, obj_name);
+					// Use another JIT instance
+					jit_compiler jit2({}, g_cfg.core.llvm_cpu, 0x1);
+					ppu_initialize2(jit2, part, cache_path, obj_name);
 
-				ppu_log.success("LLVM: Compiled module %s", obj_name);
+					// Share the object with other titles
+					rpcs3::cache::add_shared_object(cache_path, obj_name + ".gz");
+
+					ppu_log.success("LLVM: Compiled module %s", obj_name);
+					g_progr_pdone++;
+				});
+			}
+
+			sched.submit(compile_state, std::move(jobs));
+		}
+
+		named_thread_group threads(fmt::format("PPUW.%u.", ++g_fxo->get<thread_index_allocator>().index), thread_count, [&]()
+		{
+			// Set low priority
+			thread_ctrl::scoped_priority low_prio(-1);
+
+#ifdef __APPLE__
+			pthread_jit_write_protect_np(false);
+#endif
+			// Compile the most expensive parts of any module (work stealing) while this module is not compiled
+			// Stop as soon as it's compiled, parts of other modules are left to their own workers
+			while (compile_state->pending && sched.run_one())
+			{
 			}
 		});
 
 		threads.join();
 
+		// Wait for parts compiled by workers of other modules
+		for (u32 pending = compile_state->pending; pending; pending = compile_state->pending)
+		{
+			compile_state->pending.wait(pending);
+		}
+
 		g_watchdog_hold_ctr--;
 
 		if (Emu.IsStopped() || !get_current_cpu_thread())
@@ -6,12 +6,14 @@
 #include "Emu/system_progress.hpp"
 #include "Emu/system_utils.hpp"
 #include "Emu/cache_utils.hpp"
+#include "Emu/perf_trace.hpp"
 #include "Emu/IdManager.h"
 #include "Emu/Cell/timers.hpp"
 #include "Crypto/sha1.h"
 #include "Utilities/StrUtil.h"
 #include "Utilities/JIT.h"
 #include "util/init_mutex.hpp"
+#include "util/vm.hpp"
 #include "util/shared_ptr.hpp"
 
 #include "SPUThread.h"
@@ -28,6 +30,8 @@
 #include "util/simd.hpp"
 #include "util/sysinfo.hpp"
 
+#include "xxhash.h"
+
 #if defined(ARCH_ARM64)
 #include "Emu/CPU/sse2neon.h"
 #endif
@@ -512,40 +516,92 @@ DECLARE(spu_runtime::g_interpreter_table) = {};
 DECLARE(spu_runtime::g_interpreter) = nullptr;
 
 spu_cache::spu_cache(const std::string& loc)
-	: m_file(loc, fs::read + fs::write + fs::create + fs::append)
+	: m_archive(std::make_unique<utils::record_archive>(loc, c_magic, c_version, "SPU cache"))
 {
 }
 
-spu_cache::~spu_cache()
+spu_cache::records spu_cache::get()
 {
+	records result;
+
+	if (!*this)
+	{
+		return result;
+	}
+
+	// Record hashes are checked by the compile workers (verify())
+	for (const auto& rec : m_archive->get(c_program_record, false))
+	{
+		if (rec.data.size() <= 4 || rec.data.size() % 4)
+		{
+			continue;
+		}
+
+		le_t<u32> entry_point;
+		std::memcpy(&entry_point, rec.data.data(), 4);
+
+		result.list.push_back({entry_point, ::size32(rec.data) / 4 - 1, reinterpret_cast<const u32*>(rec.data.data() + 4), rec});
+	}
+
+	// Latest programs first
+	std::reverse(result.list.begin(), result.list.end());
+
+	// Keep the image mapped only while the programs are in use
+	result.image = m_archive->get_image();
+	m_archive->release_image();
+	return result;
 }
 
-std::deque<spu_program> spu_cache::get()
+bool spu_cache::verify(const spu_cache_entry& entry)
 {
-	std::deque<spu_program> result;
+	// Forgotten on mismatch, it will be added again when found
+	return m_archive->verify(c_program_record, entry.record);
+}
 
-	if (!m_file)
+void spu_cache::add(const spu_program& func)
+{
+	if (!*this)
 	{
-		return result;
+		return;
 	}
 
-	m_file.seek(0);
+	const u64 size = func.data.size() * u64{4};
+
+	// Record data: entry point followed by the program
+	std::vector<u8> data(4 + size);
+
+	const le_t<u32> entry_point = func.entry_point;
+	std::memcpy(data.data(), &entry_point, 4);
+	std::memcpy(data.data() + 4, func.data.data(), size);
+
+	m_archive->add(c_program_record, XXH64(func.data.data(), size, func.entry_point), data);
+}
+
+u32 spu_cache::import_legacy(const std::string& loc)
+{
+	fs::file file(loc);
+
+	if (!file || !*this)
+	{
+		return 0;
+	}
+
+	u32 count = 0;
 
-	// TODO: signal truncated or otherwise broken file
 	while (true)
 	{
 		be_t<u32> size;
 		be_t<u32> addr;
 		std::vector<u32> func;
 
-		if (!m_file.read(size) || !m_file.read(addr))
+		if (!file.read(size) || !file.read(addr))
 		{
 			break;
 		}
 
 		func.resize(size);
 
-		if (m_file.read(func.data(), func.size() * 4) != func.size() * 4)
+		if (file.read(func.data(), func.size() * 4) != func.size() * 4)
 		{
 			break;
 		}
@@ -560,31 +616,16 @@ std::deque<spu_program> spu_cache::get()
 		res.entry_point = addr;
 		res.lower_bound = addr;
 		res.data = std::move(func);
-		result.emplace_front(std::move(res));
+		add(res);
+		count++;
 	}
 
-	return result;
+	return count;
 }
 
-void spu_cache::add(const spu_program& func)
+bool spu_cache_entry::operator==(const spu_program& rhs) const noexcept
 {
-	if (!m_file)
-	{
-		return;
-	}
-
-	be_t<u32> size = ::size32(func.data);
-	be_t<u32> addr = func.entry_point;
-
-	const fs::iovec_clone gather[3]
-	{
-		{&size, sizeof(size)},
-		{&addr, sizeof(addr)},
-		{func.data.data(), func.data.size() * 4}
-	};
-
-	// Append data
-	m_file.write_gather(gather, 3);
+	return rhs.entry_point == rhs.lower_bound && rhs.data.size() == size && std::memcmp(rhs.data.data(), data, size * u64{4}) == 0;
 }
 
 void spu_cache::initialize()
@@ -606,8 +647,33 @@ void spu_cache::initialize()
 		return;
 	}
 
-	// SPU cache file (version + block size type)
-	const std::string loc = ppu_cache + "spu-" + fmt::to_lower(g_cfg.core.spu_block_size.to_string()) + "-v1-tane.dat";
+	// SPU cache file (version + block size type), the version matches spu_cache::c_version
+	const std::string name = "spu-" + fmt::to_lower(g_cfg.core.spu_block_size.to_string());
+	const std::string loc = ppu_cache + name + fmt::format("-v%u-tane.dat", spu_cache::c_version);
+	const std::string old_loc = ppu_cache + name + "-v1-tane.dat";
+
+	// Archives of older versions are not converted (only the original format is)
+	for (u32 version = 2; version < spu_cache::c_version; version++)
+	{
+		fs::remove_file(ppu_cache + name + fmt::format("-v%u-tane.dat", version));
+	}
+
+	// Migrate old format cache file
+	if (fs::is_file(old_loc))
+	{
+		spu_cache new_cache(loc);
+
+		if (new_cache)
+		{
+			const u32 count = new_cache.import_legacy(old_loc);
+			spu_log.success("SPU cache: Imported %u programs from %s", count, old_loc);
+
+			if (!fs::remove_file(old_loc))
+			{
+				spu_log.error("SPU cache: Failed to remove %s (%s)", old_loc, fs::g_tls_error);
+			}
+		}
+	}
 
 	spu_cache cache(loc);
 
@@ -617,8 +683,9 @@ void spu_cache::initialize()
 		return;
 	}
 
-	// Read cache
-	auto func_list = cache.get();
+	// Read cache (the data is mapped, not copied)
+	const auto cache_data = cache.get();
+	const auto& func_list = cache_data.list;
 	atomic_t<usz> fnext{};
 	atomic_t<u8> fail_flag{0};
 
@@ -690,16 +757,23 @@ void spu_cache::initialize()
 		// Build functions
 		for (usz func_i = fnext++; func_i < func_list.size(); func_i = fnext++, g_progr_pdone++)
 		{
-			const spu_program& func = std::as_const(func_list)[func_i];
+			const spu_cache_entry& func = func_list[func_i];
 
 			if (Emu.IsStopped() || fail_flag)
 			{
 				continue;
 			}
 
+			// Check record integrity
+			if (!cache.verify(func))
+			{
+				result++;
+				continue;
+			}
+
 			// Get data start
-			const u32 start = func.lower_bound;
-			const u32 size0 = ::size32(func.data);
+			const u32 start = func.entry_point;
+			const u32 size0 = func.size;
 
 			be_t<u64> hash_start;
 			{
@@ -707,7 +781,7 @@ void spu_cache::initialize()
 				u8 output[20];
 
 				sha1_starts(&ctx);
-				sha1_update(&ctx, reinterpret_cast<const u8*>(func.data.data()), func.data.size() * 4);
+				sha1_update(&ctx, reinterpret_cast<const u8*>(func.data), size0 * 4);
 				sha1_finish(&ctx, output);
 				std::memcpy(&hash_start, output, sizeof(hash_start));
 			}
@@ -729,10 +803,12 @@ void spu_cache::initialize()
 				ls[pos / 4] = std::bit_cast<be_t<u32>>(func.data[i]);
 			}
 
+			perf_trace::scope trace("SPU compile", func.entry_point);
+
 			// Call analyser
 			spu_program func2 = compiler->analyse(ls.data(), func.entry_point);
 
-			if (func2 != func)
+			if (!(func == func2))
 			{
 				spu_log.error("[0x%05x] SPU Analyser failed, %u vs %u", func2.entry_point, func2.data.size(), size0);
 			}
@@ -778,12 +854,12 @@ void spu_cache::initialize()
 			std::string dump;
 			dump.reserve(10'000'000);
 
-			std::map<std::basic_string_view<u8>, spu_program*> sorted;
+			std::map<std::basic_string_view<u8>, const spu_cache_entry*> sorted;
 
 			for (auto&& f : func_list)
 			{
 				// Interpret as a byte string
-				std::basic_string_view<u8> data = {reinterpret_cast<u8*>(f.data.data()), f.data.size() * sizeof(u32)};
+				std::basic_string_view<u8> data = {reinterpret_cast<const u8*>(f.data), f.size * sizeof(u32)};
 
 				sorted[data] = &f;
 			}
@@ -862,7 +938,7 @@ void spu_cache::initialize()
 
 				fmt::append(dump, "\n\t%49s", "");
 
-				for (u32 i = 0; i < f->data.size(); i++)
+				for (u32 i = 0; i < f->size; i++)
 				{
 					fmt::append(dump, "%-10s", g_spu_iname.decode(std::bit_cast<be_t<u32>>(f->data[i])));
 				}
@@ -10547,10 +10623,16 @@ std::unique_ptr<spu_recompiler_base> spu_recompiler_base::make_llvm_recompiler(u
 
 #endif
 
+// Number of programs compiled by SPU LLVM workers (the dispatcher waits on it when all workers are busy)
+static atomic_t<u32> g_spu_llvm_compiled = 0;
+
 struct spu_llvm_worker
 {
 	lf_queue<std::pair<u64, const spu_program*>> registered;
 
+	// Number of programs pushed and not compiled yet
+	atomic_t<u32> pending = 0;
+
 	void operator()()
 	{
 		// SPU LLVM Recompiler instance
@@ -10595,6 +10677,21 @@ struct spu_llvm_worker
 
 			const auto& func = *prog->second;
 
+			// Complete the program on every exit path (the dispatcher waits for pending programs)
+			struct pending_guard
+			{
+				atomic_t<u32>& pending;
+
+				~pending_guard()
+				{
+					pending--;
+
+					// Wake up the dispatcher if it waits for a worker
+					g_spu_llvm_compiled++;
+					g_spu_llvm_compiled.notify_one();
+				}
+			} guard{pending};
+
 			// Get data start
 			const u32 start = func.lower_bound;
 			const u32 size0 = ::size32(func.data);
@@ -10605,6 +10702,8 @@ struct spu_llvm_worker
 				ls[pos / 4] = std::bit_cast<be_t<u32>>(func.data[i]);
 			}
 
+			perf_trace::scope trace("SPU compile", func.entry_point);
+
 			// Call analyser
 			spu_program func2 = compiler->analyse(ls.data(), func.entry_point);
 
@@ -10646,6 +10745,12 @@ struct spu_llvm_worker
 // SPU LLVM recompiler thread context
 struct spu_llvm
 {
+	// Execution weight of a profiler sample (~20ms spent in the program)
+	static constexpr u64 c_sample_weight = 256;
+
+	// Max number of programs queued per worker
+	static constexpr u32 c_worker_queue_max = 2;
+
 	// Workload
 	lf_queue<std::pair<const u64, spu_item*>> registered;
 	atomic_ptr<named_thread_group<spu_llvm_worker>> m_workers;
@@ -10743,21 +10848,54 @@ struct spu_llvm
 				continue;
 			}
 
-			// Find the most used enqueued item
-			u64 sample_max = 0;
-			auto found_it  = enqueued.begin();
+			// Find a worker which can take more work (load the counter first to not miss a completion)
+			const u32 compiled = g_spu_llvm_compiled;
+			spu_llvm_worker* worker = nullptr;
+
+			for (u32 i = 0; i < worker_count; i++)
+			{
+				auto& w = *(workers.begin() + (worker_index + i) % worker_count);
+
+				if (w.pending < c_worker_queue_max)
+				{
+					worker = &w;
+					worker_index += i + 1;
+					break;
+				}
+			}
+
+			if (!worker)
+			{
+				// Wait for a worker to finish a program (new programs are collected afterwards)
+				thread_ctrl::wait_on(g_spu_llvm_compiled, compiled);
+				continue;
+			}
+
+			// Programs below the threshold stay in the fast tier until they become hot
+			const u64 threshold = g_cfg.core.spu_llvm_tiering_threshold;
+
+			// Find the hottest enqueued item (execution count and profiler samples)
+			u64 weight_max = 0;
+			auto found_it = enqueued.end();
 
 			for (auto it = enqueued.begin(), end = enqueued.end(); it != end; ++it)
 			{
-				const u64 cur = std::as_const(samples).at(it->first);
+				const u64 weight = it->second->exec_count + std::as_const(samples).at(it->first) * c_sample_weight;
 
-				if (cur > sample_max)
+				if (weight >= threshold && (found_it == end || weight > weight_max))
 				{
-					sample_max = cur;
+					weight_max = weight;
 					found_it = it;
 				}
 			}
 
+			if (found_it == enqueued.end())
+			{
+				// Wait for new programs or programs becoming hot (only with a tiering threshold)
+				thread_ctrl::wait_on(registered, nullptr, 20'000);
+				continue;
+			}
+
 			// Start compiling
 			const spu_program& func = found_it->second->data;
 
@@ -10768,7 +10906,8 @@ struct spu_llvm
 			enqueued.erase(found_it);
 
 			// Push the workload
-			(workers.begin() + (worker_index++ % worker_count))->registered.push(reinterpret_cast<u64>(_old), &func);
+			worker->pending++;
+			worker->registered.push(reinterpret_cast<u64>(_old), &func);
 		}
 
 		static_cast<void>(prof_mutex.init_always([&]{ samples.clear(); }));
@@ -10833,7 +10972,7 @@ struct spu_fast : public spu_recompiler_base
 		}
 
 		// Allocate executable area with necessary size
-		const auto result = jit_runtime::alloc(22 + 1 + 9 + ::size32(func.data) * (16 + 16) + 36 + 47, 16);
+		const auto result = jit_runtime::alloc(22 + 13 + 1 + 9 + ::size32(func.data) * (16 + 16) + 36 + 47, 16);
 
 		if (!result)
 		{
@@ -10880,6 +11019,18 @@ struct spu_fast : public spu_recompiler_base
 		*raw++ = 0x45;
 		*raw++ = ::narrow<s8>(::offset32(&spu_thread::block_hash));
 
+		// Count executions for tiering: mov rax, &exec_count
+		*raw++ = 0x48;
+		*raw++ = 0xb8;
+		const u64 exec_count_ptr = reinterpret_cast<u64>(&add_loc->exec_count);
+		std::memcpy(raw, &exec_count_ptr, sizeof(exec_count_ptr));
+		raw += 8;
+
+		// inc qword ptr [rax]
+		*raw++ = 0x48;
+		*raw++ = 0xff;
+		*raw++ = 0x00;
+
 		// Load PC: mov eax, [r13 + spu_thread::pc]
 		*raw++ = 0x41;
 		*raw++ = 0x8b;
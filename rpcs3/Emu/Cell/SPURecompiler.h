@@ -2,19 +2,48 @@
 
 #include "Utilities/File.h"
 #include "Utilities/lockless.h"
+#include "Utilities/mutex.h"
+#include "util/record_archive.hpp"
 #include "SPUThread.h"
 #include <vector>
 #include <bitset>
 #include <memory>
 #include <string>
-#include <deque>
+#include <unordered_map>
+
+// Program loaded from SPU cache (points into the cache file image)
+struct spu_cache_entry
+{
+	u32 entry_point;
+	u32 size;
+	const u32* data;
+
+	// Archive record (entry point followed by program data)
+	utils::record_archive::record record;
+
+	bool operator==(const struct spu_program& rhs) const noexcept;
+};
 
 // Helper class
 class spu_cache
 {
-	fs::file m_file;
+	std::unique_ptr<utils::record_archive> m_archive;
 
 public:
+	static constexpr u64 c_magic = "RPCS3SPU"_u64;
+	static constexpr u32 c_version = 3;
+
+	// Record type of SPU programs
+	static constexpr u32 c_program_record = "SPUP"_u32;
+
+	struct records
+	{
+		// Keeps data of entries alive
+		std::shared_ptr<u8> image;
+
+		std::vector<spu_cache_entry> list;
+	};
+
 	spu_cache() = default;
 
 	spu_cache(const std::string& loc);
@@ -23,17 +52,22 @@ public:
 
 	spu_cache& operator=(spu_cache&&) noexcept = default;
 
-	~spu_cache();
-
 	operator bool() const
 	{
-		return m_file.operator bool();
+		return m_archive && *m_archive;
 	}
 
-	std::deque<struct spu_program> get();
+	// Get all programs from the file image (can only be called once)
+	records get();
+
+	// Check record hash, forget the record on mismatch
+	bool verify(const spu_cache_entry& entry);
 
 	void add(const struct spu_program& func);
 
+	// Add programs from the old format cache file
+	u32 import_legacy(const std::string& loc);
+
 	static void initialize();
 };
 
@@ -68,6 +102,9 @@ public:
 	atomic_t<u8> cached = false;
 	atomic_t<u8> logged = false;
 
+	// Number of executions in the fast tier (incremented non-atomically by generated code)
+	atomic_t<u64> exec_count = 0;
+
 	spu_item(spu_program&& data)
 		: data(std::move(data))
 	{
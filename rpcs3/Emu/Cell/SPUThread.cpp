@@ -486,7 +486,7 @@ const auto spu_putllc_tx = build_function_asm<u64(*)(u32 raddr, u64 rtime, void*
 	c.lea(args[1], x86::qword_ptr(args[1], args[0]));
 	c.prefetchw(x86::byte_ptr(args[1], 0));
 	c.prefetchw(x86::byte_ptr(args[1], 64));
-	c.and_(args[0].r32(), 0xff80);
+	c.and_(args[0].r32(), vm::rsrv_table_mask);
 	c.shr(args[0].r32(), 1);
 	c.lea(x86::r11, x86::qword_ptr(reinterpret_cast<u64>(+vm::g_reservations), args[0]));
 
@@ -747,7 +747,7 @@ const auto spu_putlluc_tx = build_function_asm<u64(*)(u32 raddr, const void* rda
 		c.movaps(x86::xmm7, x86::oword_ptr(args[1], 112));
 	}
 
-	c.and_(args[0].r32(), 0xff80);
+	c.and_(args[0].r32(), vm::rsrv_table_mask);
 	c.shr(args[0].r32(), 1);
 	c.lea(args[1], x86::qword_ptr(reinterpret_cast<u64>(+vm::g_reservations), args[0]));
 
@@ -851,7 +851,7 @@ const auto spu_getllar_tx = build_function_asm<u64(*)(u32 raddr, void* rdata, cp
 	build_swap_rdx_with(c, args, x86::r10);
 	c.mov(x86::rbp, x86::qword_ptr(reinterpret_cast<u64>(&vm::g_sudo_addr)));
 	c.lea(x86::rbp, x86::qword_ptr(x86::rbp, args[0]));
-	c.and_(args[0].r32(), 0xff80);
+	c.and_(args[0].r32(), vm::rsrv_table_mask);
 	c.shr(args[0].r32(), 1);
 	c.lea(x86::r11, x86::qword_ptr(reinterpret_cast<u64>(+vm::g_reservations), args[0]));
 
@@ -1654,6 +1654,8 @@ spu_thread::~spu_thread()
 
 	perf_log.notice("Perf stats for transactions: success %u, failure %u", stx, ftx);
 	perf_log.notice("Perf stats for PUTLLC reload: successs %u, failure %u", last_succ, last_fail);
+
+	vm::reservation_add_failures(rsrv_failures);
 }
 
 u8* spu_thread::map_ls(utils::shm& shm)
@@ -2238,7 +2240,7 @@ void spu_thread::do_dma_transfer(spu_thread* _this, const spu_mfc_cmd& args, u8*
 				auto& res = vm::reservation_acquire(eal);
 
 				// Lock each bit corresponding to a byte being written, using some free space in reservation memory
-				auto* bits = utils::bless<atomic_t<u128>>(vm::g_reservations + ((eal & 0xff80) / 2 + 16));
+				auto* bits = utils::bless<atomic_t<u128>>(vm::g_reservations + ((eal & vm::rsrv_table_mask) / 2 + 16));
 
 				// Get writing mask
 				const u128 wmask = (~u128{} << (eal & 127)) & (~u128{} >> (127 - ((eal + size0 - 1) & 127)));
@@ -2819,6 +2821,7 @@ bool spu_thread::do_putllc(const spu_mfc_cmd& args)
 
 		if (rtime != res)
 		{
+			(!cmp_rdata(rdata, vm::_ref<spu_rdata_t>(addr)) ? rsrv_failures.conflicts : rsrv_failures.collisions)++;
 			return false;
 		}
 
@@ -3013,7 +3016,7 @@ void do_cell_atomic_128_store(u32 addr, const void* to_write)
 
 	{
 		auto& sdata = *vm::get_super_ptr<spu_rdata_t>(addr);
-		auto& res = *utils::bless<atomic_t<u128>>(vm::g_reservations + (addr & 0xff80) / 2);
+		auto& res = *utils::bless<atomic_t<u128>>(vm::g_reservations + (addr & vm::rsrv_table_mask) / 2);
 
 		for (u64 j = 0;; j++)
 		{
@@ -840,6 +840,7 @@ public:
 	u32 last_faddr = 0;
 	u64 last_fail = 0;
 	u64 last_succ = 0;
+	vm::reservation_failures rsrv_failures{}; // Counted without atomics, added to the totals on destruction
 	u64 last_gtsc = 0;
 	u32 last_getllar = umax; // LS address of last GETLLAR (if matches current GETLLAR we can let the thread rest)
 	u32 last_getllar_id = umax;
@@ -2,6 +2,7 @@
 #include "Emu/System.h"
 #include "Emu/Memory/vm_ptr.h"
 #include "Emu/Memory/vm_locking.h"
+#include "Emu/perf_trace.hpp"
 
 #include "Emu/Cell/PPUFunction.h"
 #include "Emu/Cell/ErrorCodes.h"
@@ -1201,6 +1202,42 @@ static std::deque<std::pair<u64, class cpu_thread*>> g_waiting;
 // Threads which must call lv2_obj::sleep before the scheduler starts
 static std::deque<class cpu_thread*> g_to_sleep;
 
+// Threads woken by non-PPU threads, scheduled by the next scheduler lock owner
+static lf_queue<cpu_thread*> g_deferred_wakes;
+
+// Scheduler lock statistics
+static atomic_t<u64> g_scheduler_lock_waits{}; // Lock acquisitions which had to wait for another thread
+static atomic_t<u64> g_scheduler_wakes_deferred{}; // Wakeups left to the lock owner
+
+// Set while the scheduler lock is owned by a thread which checks g_deferred_wakes after unlocking
+// Other holders (readers, debugger) don't, wakers wait for them instead of deferring
+static atomic_t<bool> g_scheduler_lock_checked{};
+
+// Scheduler lock which counts contention, lv2_obj::schedule_deferred() must be called after unlocking
+struct scheduler_lock
+{
+	scheduler_lock() noexcept
+	{
+		if (!lv2_obj::g_mutex.try_lock()) [[unlikely]]
+		{
+			g_scheduler_lock_waits++;
+			lv2_obj::g_mutex.lock();
+		}
+
+		g_scheduler_lock_checked = true;
+	}
+
+	scheduler_lock(const scheduler_lock&) = delete;
+
+	scheduler_lock& operator=(const scheduler_lock&) = delete;
+
+	~scheduler_lock()
+	{
+		g_scheduler_lock_checked = false;
+		lv2_obj::g_mutex.unlock();
+	}
+};
+
 namespace cpu_counter
 {
 	void remove(cpu_thread*) noexcept;
@@ -1214,10 +1251,12 @@ bool lv2_obj::sleep(cpu_thread& cpu, const u64 timeout)
 		prepare_for_sleep(cpu);
 	}
 
+	perf_trace::instant("lv2 sleep", cpu.id);
+
 	bool result = false;
 	const u64 current_time = get_guest_system_time();
 	{
-		std::lock_guard lock{g_mutex};
+		scheduler_lock lock;
 		result = sleep_unlocked(cpu, timeout, current_time);
 
 		if (!g_to_awake.empty())
@@ -1226,6 +1265,7 @@ bool lv2_obj::sleep(cpu_thread& cpu, const u64 timeout)
 			awake_unlocked({});
 		}
 
+		awake_deferred_unlocked();
 		schedule_all(current_time);
 	}
 
@@ -1235,15 +1275,35 @@ bool lv2_obj::sleep(cpu_thread& cpu, const u64 timeout)
 	}
 
 	g_to_awake.clear();
+	schedule_deferred();
 	return result;
 }
 
 bool lv2_obj::awake(cpu_thread* thread, s32 prio)
 {
+	perf_trace::instant("lv2 awake", thread ? thread->id : 0);
+
+	if (thread && prio == enqueue_cmd && g_scheduler_lock_checked && !cpu_thread::get_current<ppu_thread>())
+	{
+		// Wakeup from SPU or host threads while the scheduler is busy: don't wait for the lock, its owner schedules the thread
+		// Not for PPU threads, scheduling also updates the state of the current PPU thread
+		// The result is not known here (see declaration), callers of enqueue_cmd wakeups ignore it
+		g_deferred_wakes.push(thread);
+		schedule_deferred();
+
+		if (auto cpu = cpu_thread::get_current(); cpu && cpu->is_paused())
+		{
+			vm::temporary_unlock();
+		}
+
+		return true;
+	}
+
 	bool result = false;
 	{
-		std::lock_guard lock(g_mutex);
+		scheduler_lock lock;
 		result = awake_unlocked(thread, prio);
+		awake_deferred_unlocked();
 		schedule_all();
 	}
 
@@ -1260,9 +1320,55 @@ bool lv2_obj::awake(cpu_thread* thread, s32 prio)
 		notify_all();
 	}
 
+	schedule_deferred();
 	return result;
 }
 
+void lv2_obj::awake_deferred_unlocked()
+{
+	if (!g_deferred_wakes)
+	{
+		return;
+	}
+
+	for (cpu_thread* cpu : g_deferred_wakes.pop_all())
+	{
+		awake_unlocked(cpu);
+	}
+}
+
+void lv2_obj::schedule_deferred()
+{
+	// Wakeups queued after the lock owner has checked the queue are scheduled here
+	while (g_deferred_wakes)
+	{
+		if (!g_mutex.try_lock())
+		{
+			if (g_scheduler_lock_checked)
+			{
+				// The lock owner will check the queue after unlocking
+				g_scheduler_wakes_deferred++;
+				return;
+			}
+
+			// Held by readers or another thread which doesn't check the queue
+			g_scheduler_lock_waits++;
+			g_mutex.lock();
+		}
+
+		g_scheduler_lock_checked = true;
+		awake_deferred_unlocked();
+		schedule_all();
+		g_scheduler_lock_checked = false;
+		g_mutex.unlock();
+
+		if (!g_postpone_notify_barrier)
+		{
+			notify_all();
+		}
+	}
+}
+
 bool lv2_obj::yield(cpu_thread& thread)
 {
 	if (auto ppu = thread.try_get<ppu_thread>())
@@ -1572,9 +1678,12 @@ bool lv2_obj::awake_unlocked(cpu_thread* cpu, s32 prio)
 
 void lv2_obj::cleanup()
 {
+	ppu_log.notice("Scheduler lock: %u contended acquisitions, %u wakeups deferred", g_scheduler_lock_waits.exchange(0), g_scheduler_wakes_deferred.exchange(0));
+
 	g_ppu = nullptr;
 	g_to_sleep.clear();
 	g_waiting.clear();
+	g_deferred_wakes.pop_all();
 	g_pending = 0;
 }
 
@@ -1582,6 +1691,12 @@ void lv2_obj::schedule_all(u64 current_time)
 {
 	usz notify_later_idx = 0;
 
+	// Keep notifications postponed by the caller (g_postpone_notify_barrier)
+	while (notify_later_idx < std::size(g_to_notify) && g_to_notify[notify_later_idx])
+	{
+		notify_later_idx++;
+	}
+
 	if (!g_pending && g_to_sleep.empty())
 	{
 		auto target = +g_ppu;
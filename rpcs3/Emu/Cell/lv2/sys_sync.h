@@ -230,11 +230,20 @@ private:
 	// Schedule the thread
 	static bool awake_unlocked(cpu_thread*, s32 prio = enqueue_cmd);
 
+	// Schedule threads woken without the scheduler lock
+	static void awake_deferred_unlocked();
+
+	// Lock the scheduler if it's free and schedule threads woken without the lock
+	static void schedule_deferred();
+
 public:
 	static constexpr u64 max_timeout = u64{umax} / 1000;
 
 	static bool sleep(cpu_thread& cpu, const u64 timeout = 0);
 
+	// Returns true if the thread queue was changed (yield_cmd: true on context switch)
+	// Wakeups with enqueue_cmd from non-PPU threads may be left to the scheduler lock owner when it is busy,
+	// true is returned in this case without knowing the outcome: don't use the result of enqueue_cmd wakeups
 	static bool awake(cpu_thread* thread, s32 prio = enqueue_cmd);
 
 	// Returns true on successful context switch, false otherwise
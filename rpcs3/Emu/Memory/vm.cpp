@@ -59,7 +59,15 @@ namespace vm
 	u8* const g_free_addr = g_stat_addr + 0x1'0000'0000;
 
 	// Reservation stats
-	alignas(4096) u8 g_reservations[65536 / 128 * 64]{0};
+	alignas(4096) u8 g_reservations[(1u << rsrv_table_addr_bits) / 128 * 64]{0};
+
+	// Failed conditional stores of destroyed threads
+	static struct
+	{
+		atomic_t<u64> collisions;
+		atomic_t<u64> conflicts;
+		atomic_t<u64> unknown;
+	} s_rsrv_failures;
 
 	// Pointers to shared memory mirror or zeros for "normal" memory
 	alignas(4096) atomic_t<u64> g_shmem[65536]{0};
@@ -1539,6 +1547,9 @@ namespace vm
 
 			// Patch bitmap with correct value
 			*std::prev(&ar.data.back(), count * 128) = bitmap;
+
+			// Flush to file if streaming
+			ar.breathe();
 		}
 	}
 
@@ -1580,7 +1591,7 @@ namespace vm
 				if (is_memory_compatible_for_copy_from_executable_optimization(addr, shm.first))
 				{
 					// Revert changes
-					ar.data.resize(ar.seek_end(sizeof(u32) * 2 + sizeof(memory_page)));
+					ar.trunc(sizeof(u32) * 2 + sizeof(memory_page));
 					vm_log.success("Removed memory block matching the memory of the executable from savestate. (addr=0x%x, size=0x%x)", addr, shm.first);
 					continue;
 				}
@@ -1971,6 +1982,9 @@ namespace vm
 
 			std::memset(g_reservations, 0, sizeof(g_reservations));
 			std::memset(g_shmem, 0, sizeof(g_shmem));
+			s_rsrv_failures.collisions.release(0);
+			s_rsrv_failures.conflicts.release(0);
+			s_rsrv_failures.unknown.release(0);
 			std::memset(g_range_lock_set, 0, sizeof(g_range_lock_set));
 			g_range_lock_bits = 0;
 
@@ -1981,8 +1995,18 @@ namespace vm
 		}
 	}
 
+	void reservation_add_failures(const reservation_failures& failures)
+	{
+		s_rsrv_failures.collisions += failures.collisions;
+		s_rsrv_failures.conflicts += failures.conflicts;
+		s_rsrv_failures.unknown += failures.unknown;
+	}
+
 	void close()
 	{
+		vm_log.notice("Reservation stats: %u collisions, %u conflicts, %u unknown (table covers 0x%x bytes)", s_rsrv_failures.collisions.load(), s_rsrv_failures.conflicts.load(),
+			s_rsrv_failures.unknown.load(), 1u << rsrv_table_addr_bits);
+
 		{
 			vm::writer_lock lock;
 
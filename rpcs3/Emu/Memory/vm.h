@@ -24,6 +24,26 @@ namespace vm
 	extern u8* const g_free_addr;
 	extern u8 g_reservations[];
 
+	// Reservation table: 64 bytes per 128-byte line of the covered address range
+	// Lines which are a multiple of the covered size apart share a reservation
+	constexpr u32 rsrv_table_addr_bits = 22;
+	constexpr u32 rsrv_table_mask = (1u << rsrv_table_addr_bits) - 128;
+
+	static_assert(rsrv_table_addr_bits >= 16 && rsrv_table_addr_bits <= 26);
+
+	// Failed conditional stores of a thread: a collision is a stamp change while the line data is unchanged
+	// (another line sharing the reservation, or the same data written back), a conflict is a data change,
+	// unknown failures are stamp changes when only the reserved doubleword is known
+	struct reservation_failures
+	{
+		u64 collisions = 0;
+		u64 conflicts = 0;
+		u64 unknown = 0;
+	};
+
+	// Add failures of a destroyed thread to the totals logged by close()
+	void reservation_add_failures(const reservation_failures& failures);
+
 	struct writer_lock;
 
 	enum memory_location_t : uint
@@ -30,7 +30,7 @@ namespace vm
 	inline atomic_t<u64>& reservation_acquire(u32 addr)
 	{
 		// Access reservation info: stamp and the lock bit
-		return *reinterpret_cast<atomic_t<u64>*>(g_reservations + (addr & 0xff80) / 2);
+		return *reinterpret_cast<atomic_t<u64>*>(g_reservations + (addr & rsrv_table_mask) / 2);
 	}
 
 	// Update reservation status
@@ -39,7 +39,7 @@ namespace vm
 	// Get reservation sync variable
 	inline atomic_t<u64>& reservation_notifier(u32 addr)
 	{
-		return *reinterpret_cast<atomic_t<u64>*>(g_reservations + (addr & 0xff80) / 2);
+		return *reinterpret_cast<atomic_t<u64>*>(g_reservations + (addr & rsrv_table_mask) / 2);
 	}
 
 	u64 reservation_lock_internal(u32, atomic_t<u64>&);
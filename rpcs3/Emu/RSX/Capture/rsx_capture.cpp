@@ -17,18 +17,52 @@ namespace rsx
 		{
 			if (!data.data.empty())
 			{
+				// Blocks are identified by the hash of raw data for the whole capture
 				u64 data_hash = XXH64(data.data.data(), data.data.size(), 0);
 				block.data_state = data_hash;
 
+				// Previous data at this location
+				auto& [last_state, last_data] = frame_capture.block_history[u64{block.location} << 32 | block.offset];
+
 				auto it = frame_capture.memory_data_map.find(data_hash);
 				if (it != frame_capture.memory_data_map.end())
 				{
-					if (it->second.data != data.data)
+					// Delta encoded blocks can't be compared cheaply
+					if (it->second.delta_base ? it->second.data.size() != data.data.size() : it->second.data != data.data)
 						// screw this
 						fmt::throw_exception("Memory map hash collision detected...cant capture");
 				}
 				else
-					frame_capture.memory_data_map.insert(std::make_pair(data_hash, std::move(data)));
+				{
+					frame_capture_data::memory_block_data stored;
+
+					const auto base = last_state ? frame_capture.memory_data_map.find(last_state) : frame_capture.memory_data_map.end();
+
+					if (base != frame_capture.memory_data_map.end() && base->second.delta_depth < frame_capture_data::c_max_delta_depth && last_data.size() == data.data.size())
+					{
+						// XOR encode against the previous data at this location, unchanged parts become zeros which compress well
+						stored.data.resize(data.data.size());
+						stored.delta_base = last_state;
+						stored.delta_depth = base->second.delta_depth + 1;
+
+						for (usz i = 0; i < data.data.size(); i++)
+						{
+							stored.data[i] = data.data[i] ^ last_data[i];
+						}
+					}
+					else
+					{
+						stored.data = data.data;
+					}
+
+					frame_capture.memory_data_map.insert(std::make_pair(data_hash, std::move(stored)));
+				}
+
+				if (last_state != data_hash)
+				{
+					last_state = data_hash;
+					last_data = std::move(data.data);
+				}
 
 				u64 block_hash = XXH64(&block, sizeof(frame_capture_data::memory_block), 0);
 				mem_changes.insert(block_hash);
@@ -5,11 +5,45 @@
 #include "Emu/Cell/lv2/sys_rsx.h"
 #include "Emu/Cell/lv2/sys_memory.h"
 #include "Emu/RSX/RSXThread.h"
+#include "Emu/RSX/gcm_printing.h"
 
 #include "util/asm.hpp"
 
+#include <chrono>
+
 namespace rsx
 {
+	bool frame_capture_data::get_block_data(u64 data_state, std::vector<u8>& out) const
+	{
+		const auto found = memory_data_map.find(data_state);
+
+		if (found == memory_data_map.end())
+		{
+			return false;
+		}
+
+		const auto& block = found->second;
+
+		if (!block.delta_base)
+		{
+			out = block.data;
+			return true;
+		}
+
+		// Decode the base first (the depth of chains is limited)
+		if (block.delta_base == data_state || !get_block_data(block.delta_base, out) || out.size() != block.data.size())
+		{
+			return false;
+		}
+
+		for (usz i = 0; i < out.size(); i++)
+		{
+			out[i] ^= block.data[i];
+		}
+
+		return true;
+	}
+
 	be_t<u32> rsx_replay_thread::allocate_context()
 	{
 		u32 buffer_size = 4;
@@ -108,12 +142,10 @@ namespace rsx
 				fmt::throw_exception("requested memory state for command not found in memory_map");
 
 			const auto& memblock = it->second;
-			auto it_data = frame->memory_data_map.find(it->second.data_state);
-			if (it_data == frame->memory_data_map.end())
+			if (!frame->get_block_data(memblock.data_state, block_data))
 				fmt::throw_exception("requested memory data state for command not found in memory_data_map");
 
-			const auto& data_block = it_data->second;
-			std::memcpy(vm::base(get_address(memblock.offset, memblock.location)), data_block.data.data(), data_block.data.size());
+			std::memcpy(vm::base(get_address(memblock.offset, memblock.location)), block_data.data(), block_data.size());
 		}
 
 		if (replay_cmd.display_buffer_state != 0 && replay_cmd.display_buffer_state != cs.display_buffer_hash)
@@ -167,12 +199,66 @@ namespace rsx
 		}
 	}
 
+	static std::string get_bench_report(const replay_profile_t& profile, u32 loops, u64 frames, u64 elapsed_us, u64 elapsed_ticks)
+	{
+		// Calibrate TSC against the wall clock over the whole run
+		const f64 ticks_per_ms = elapsed_us ? elapsed_ticks * 1000. / elapsed_us : 1.;
+		const f64 seconds = elapsed_us / 1e6;
+
+		std::string report = fmt::format("RSX replay benchmark: %u loops, %u frames, %u draws in %.3f s\n", loops, frames, profile.draw_calls, seconds);
+		fmt::append(report, "Draws/s: %.1f, Frames/s: %.1f\n\n", seconds ? profile.draw_calls / seconds : 0., seconds ? frames / seconds : 0.);
+
+		fmt::append(report, "%-24s %12s\n", "Category", "Time(ms)");
+		fmt::append(report, "%-24s %12.3f\n", "FIFO decode", profile.fifo_decode_ticks / ticks_per_ms);
+		fmt::append(report, "%-24s %12.3f\n", "Texture cache", profile.texture_cache_ticks / ticks_per_ms);
+		fmt::append(report, "%-24s %12.3f\n\n", "Surface store", profile.surface_store_ticks / ticks_per_ms);
+
+		std::vector<u32> regs;
+
+		for (u32 reg = 0; reg < profile.method_calls.size(); reg++)
+		{
+			if (profile.method_calls[reg])
+			{
+				regs.push_back(reg);
+			}
+		}
+
+		// Most expensive methods first
+		std::sort(regs.begin(), regs.end(), [&](u32 a, u32 b)
+		{
+			return profile.method_ticks[a] > profile.method_ticks[b];
+		});
+
+		fmt::append(report, "%-56s %12s %12s %12s\n", "Method", "Calls", "Time(ms)", "ns/call");
+
+		for (u32 reg : regs)
+		{
+			const f64 ms = profile.method_ticks[reg] / ticks_per_ms;
+			fmt::append(report, "%-56s %12u %12.3f %12.1f\n", rsx::get_method_name(reg), profile.method_calls[reg], ms, ms * 1e6 / profile.method_calls[reg]);
+		}
+
+		return report;
+	}
+
 	void rsx_replay_thread::cpu_task()
 	{
 		be_t<u32> context_id = allocate_context();
 
 		auto fifo_stops = alloc_write_fifo(context_id);
 
+		auto render = get_current_renderer();
+
+		if (bench_loops)
+		{
+			// The FIFO is idle until the put pointer is moved
+			render->replay_profile = std::make_unique<replay_profile_t>();
+		}
+
+		const auto bench_start = std::chrono::steady_clock::now();
+		const u64 bench_start_tsc = utils::get_tsc();
+		const u64 bench_start_flip = render->int_flip_index;
+		u32 loops_done = 0;
+
 		while (!Emu.IsStopped())
 		{
 			// Load registers while the RSX is still idle
@@ -182,7 +268,6 @@ namespace rsx
 			// start up fifo buffer by dumping the put ptr to first stop
 			sys_rsx_context_attribute(context_id, 0x001, 0x10000000, fifo_stops[0], 0, 0);
 
-			auto render = get_current_renderer();
 			auto last_flip = render->int_flip_index;
 
 			usz stopIdx = 0;
@@ -234,10 +319,35 @@ namespace rsx
 				render->request_emu_flip(1u);
 			}
 
+			if (bench_loops)
+			{
+				// Replay back to back
+				if (++loops_done == bench_loops)
+				{
+					break;
+				}
+
+				continue;
+			}
+
 			// random pause to not destroy gpu
 			thread_ctrl::wait_for(10'000);
 		}
 
+		if (bench_loops && loops_done == bench_loops)
+		{
+			const u64 elapsed_tsc = utils::get_tsc() - bench_start_tsc;
+			const u64 elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bench_start).count();
+			const std::string report = get_bench_report(*render->replay_profile, loops_done, render->int_flip_index - bench_start_flip, elapsed_us, elapsed_tsc);
+
+			rsx_log.notice("%s", report);
+
+			if (bench_done)
+			{
+				bench_done(report);
+			}
+		}
+
 		get_current_cpu_thread()->state += (cpu_flag::exit + cpu_flag::wait);
 	}
 }
@@ -2,7 +2,9 @@
 
 #include "Emu/CPU/CPUThread.h"
 #include "Emu/RSX/rsx_methods.h"
+#include "util/tsc.hpp"
 
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -11,14 +13,19 @@ namespace rsx
 	enum : u32
 	{
 		c_fc_magic = "RRC"_u32,
-		c_fc_version = 0x5,
+		c_fc_version = 0x6,
 	};
 
 	struct frame_capture_data
 	{
+		// Max number of delta encoded blocks between raw blocks
+		static constexpr u32 c_max_delta_depth = 16;
+
 		struct memory_block_data
 		{
 			std::vector<u8> data{};
+			u64 delta_base{0}; // Data state this block is XOR encoded against (0 if raw)
+			u32 delta_depth{0}; // Number of blocks in the delta chain (not saved)
 		};
 
 		// simple block to hold ps3 address and data
@@ -105,17 +112,66 @@ namespace rsx
 		// Initial registers state at the beginning of the capture
 		rsx::rsx_state reg_state;
 
+		// Last data state of memory blocks by location and offset, used as the base for delta encoding (not saved)
+		std::unordered_map<u64, std::pair<u64, std::vector<u8>>> block_history;
+
 		void reset()
 		{
 			magic = c_fc_magic;
 			version = c_fc_version;
 			tile_map.clear();
 			memory_map.clear();
+			memory_data_map.clear();
+			display_buffers_map.clear();
+			block_history.clear();
 			replay_commands.clear();
 			reg_state = method_registers;
 		}
+
+		// Get decoded data of a memory block
+		bool get_block_data(u64 data_state, std::vector<u8>& out) const;
+	};
+
+
+	// Detailed FIFO timing collected by the RSX thread during replay benchmarks (TSC ticks)
+	struct replay_profile_t
+	{
+		// Indexed by method register
+		std::array<u64, 0x10000 / 4> method_ticks{};
+		std::array<u64, 0x10000 / 4> method_calls{};
+
+		u64 fifo_decode_ticks = 0;
+		u64 texture_cache_ticks = 0;
+		u64 surface_store_ticks = 0;
+		u64 draw_calls = 0;
 	};
 
+	// Adds the ticks elapsed in the current scope to a profile counter, does nothing if profile is null
+	class replay_profile_scope
+	{
+		u64* m_counter = nullptr;
+		u64 m_start = 0;
+
+	public:
+		replay_profile_scope(replay_profile_t* profile, u64 replay_profile_t::*counter) noexcept
+		{
+			if (profile) [[unlikely]]
+			{
+				m_counter = &(profile->*counter);
+				m_start = utils::get_tsc();
+			}
+		}
+
+		replay_profile_scope(const replay_profile_scope&) = delete;
+
+		~replay_profile_scope()
+		{
+			if (m_counter) [[unlikely]]
+			{
+				*m_counter += utils::get_tsc() - m_start;
+			}
+		}
+	};
 
 	class rsx_replay_thread : public cpu_thread
 	{
@@ -143,10 +199,19 @@ namespace rsx
 		current_state cs{};
 		std::unique_ptr<frame_capture_data> frame;
 
+		// Memory block decoding buffer
+		std::vector<u8> block_data;
+
+		// Benchmark mode: number of loops to replay and report callback
+		u32 bench_loops = 0;
+		std::function<void(std::string)> bench_done;
+
 	public:
-		rsx_replay_thread(std::unique_ptr<frame_capture_data>&& frame_data)
+		rsx_replay_thread(std::unique_ptr<frame_capture_data>&& frame_data, u32 loops = 0, std::function<void(std::string)> on_bench_done = nullptr)
 			: cpu_thread(0)
 			, frame(std::move(frame_data))
+			, bench_loops(loops)
+			, bench_done(std::move(on_bench_done))
 		{
 		}
 
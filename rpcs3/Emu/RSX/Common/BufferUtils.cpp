@@ -33,6 +33,7 @@
 #define SSE4_1_FUNC
 #define AVX2_FUNC
 #define AVX3_FUNC
+#define AVX3_ICL_FUNC
 #else
 #ifndef __clang__
 #define PLAIN_FUNC __attribute__((optimize("no-tree-vectorize")))
@@ -42,6 +43,7 @@
 #define SSE4_1_FUNC __attribute__((__target__("sse4.1")))
 #define AVX2_FUNC __attribute__((__target__("avx2")))
 #define AVX3_FUNC __attribute__((__target__("avx512f,avx512bw,avx512dq,avx512cd,avx512vl")))
+#define AVX3_ICL_FUNC __attribute__((__target__("avx512f,avx512bw,avx512dq,avx512cd,avx512vl,avx512vbmi2")))
 #ifndef __AVX2__
 using __m256i = long long __attribute__((vector_size(32)));
 #endif
@@ -89,6 +91,10 @@ constexpr bool s_use_avx2 = false;
 constexpr bool s_use_avx3 = false;
 #endif
 
+#if defined(ARCH_X64)
+const bool s_use_avx3_icl = utils::has_avx512_icl();
+#endif
+
 const v128 s_bswap_u32_mask = _mm_set_epi8(
 	0xC, 0xD, 0xE, 0xF,
 	0x8, 0x9, 0xA, 0xB,
@@ -917,3 +923,151 @@ std::tuple<u32, u32, u32> write_index_array_data_to_buffer(std::span<std::byte>
 		fmt::throw_exception("Unreachable");
 	}
 }
+
+namespace
+{
+	PLAIN_FUNC void gather_vertex_data_naive(std::byte* dst, const std::byte* src, u32 src_stride, u32 count, std::span<const rsx::vertex_gather_span> spans)
+	{
+		for (u32 i = 0; i < count; i++, src += src_stride)
+		{
+			for (const auto& span : spans)
+			{
+				std::memcpy(dst, src + span.offset, span.length);
+				dst += span.length;
+			}
+		}
+	}
+
+	// Single span of a common attribute size
+	template <u32 Length>
+	void gather_vertex_data_span(std::byte* dst, const std::byte* src, u32 src_stride, u32 count)
+	{
+		for (u32 i = 0; i < count; i++, src += src_stride, dst += Length)
+		{
+			std::memcpy(dst, src, Length);
+		}
+	}
+
+	// Vertex of up to 64 bytes packed into at most 16 bytes, each 16-byte chunk of the vertex is shuffled into place
+	template <u32 Chunks>
+	SSE4_1_FUNC void gather_vertex_data_sse41(std::byte* dst, const std::byte* src, u32 src_stride, u32 count, u32 packed_stride, const u8 (&controls)[4][16],
+		std::span<const rsx::vertex_gather_span> spans)
+	{
+		__m128i shuffle[Chunks];
+
+		for (u32 c = 0; c < Chunks; c++)
+		{
+			shuffle[c] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(controls[c]));
+		}
+
+		// Loads and stores are 16-byte wide, stop before they exceed the buffers
+		const usz src_size = usz{src_stride} * count;
+		const usz dst_size = usz{packed_stride} * count;
+		const usz src_safe = src_size >= Chunks * 16 ? (src_size - Chunks * 16) / src_stride + 1 : 0;
+		const usz dst_safe = dst_size >= 16 ? (dst_size - 16) / packed_stride + 1 : 0;
+		const u32 safe_count = static_cast<u32>(std::min<usz>({count, src_safe, dst_safe}));
+
+		for (u32 i = 0; i < safe_count; i++, src += src_stride, dst += packed_stride)
+		{
+			__m128i result = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), shuffle[0]);
+
+			for (u32 c = 1; c < Chunks; c++)
+			{
+				result = _mm_or_si128(result, _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + c * 16)), shuffle[c]));
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), result);
+		}
+
+		gather_vertex_data_naive(dst, src, src_stride, count - safe_count, spans);
+	}
+
+#if defined(ARCH_X64)
+	// Vertex of up to 64 bytes, selected bytes are compressed with a single instruction
+	AVX3_ICL_FUNC void gather_vertex_data_avx3_icl(std::byte* dst, const std::byte* src, u32 src_stride, u32 count, u32 packed_stride, u64 vertex_mask)
+	{
+		// Masked loads and stores do not fault on unselected bytes, no tail processing is required
+		const __mmask64 load_mask = src_stride == 64 ? umax : (1ull << src_stride) - 1;
+		const __mmask64 store_mask = packed_stride == 64 ? umax : (1ull << packed_stride) - 1;
+
+		for (u32 i = 0; i < count; i++, src += src_stride, dst += packed_stride)
+		{
+			const __m512i data = _mm512_maskz_loadu_epi8(load_mask, src);
+			_mm512_mask_storeu_epi8(dst, store_mask, _mm512_maskz_compress_epi8(vertex_mask, data));
+		}
+	}
+#endif
+}
+
+void gather_vertex_data(std::byte* dst, const std::byte* src, u32 src_stride, u32 count, std::span<const rsx::vertex_gather_span> spans, rsx::vertex_gather_kernel kernel)
+{
+	const bool automatic = kernel == rsx::vertex_gather_kernel::automatic;
+
+	u32 packed_stride = 0;
+
+	for (const auto& span : spans)
+	{
+		packed_stride += span.length;
+	}
+
+	if (automatic && spans.size() == 1)
+	{
+		const std::byte* start = src + spans[0].offset;
+
+		switch (spans[0].length)
+		{
+		case 4: return gather_vertex_data_span<4>(dst, start, src_stride, count);
+		case 8: return gather_vertex_data_span<8>(dst, start, src_stride, count);
+		case 12: return gather_vertex_data_span<12>(dst, start, src_stride, count);
+		case 16: return gather_vertex_data_span<16>(dst, start, src_stride, count);
+		default: break;
+		}
+	}
+
+	if (src_stride > 64 || kernel == rsx::vertex_gather_kernel::scalar)
+	{
+		return gather_vertex_data_naive(dst, src, src_stride, count, spans);
+	}
+
+#if defined(ARCH_X64)
+	if (automatic ? s_use_avx3_icl : kernel == rsx::vertex_gather_kernel::avx512_vbmi2)
+	{
+		u64 vertex_mask = 0;
+
+		for (const auto& span : spans)
+		{
+			vertex_mask |= (span.length == 64 ? umax : (1ull << span.length) - 1) << span.offset;
+		}
+
+		return gather_vertex_data_avx3_icl(dst, src, src_stride, count, packed_stride, vertex_mask);
+	}
+#endif
+
+	if ((automatic ? s_use_sse4_1 : kernel == rsx::vertex_gather_kernel::sse4_1) && packed_stride <= 16)
+	{
+		// Byte shuffle controls for each chunk of the vertex (bit 7 clears the output byte)
+		u8 controls[4][16];
+		std::memset(controls, 0x80, sizeof(controls));
+
+		u32 out = 0;
+
+		for (const auto& span : spans)
+		{
+			for (u32 b = span.offset; b < span.offset + span.length; b++)
+			{
+				controls[b / 16][out++] = b % 16;
+			}
+		}
+
+		switch (utils::aligned_div(src_stride, 16))
+		{
+		case 1: return gather_vertex_data_sse41<1>(dst, src, src_stride, count, packed_stride, controls, spans);
+		case 2: return gather_vertex_data_sse41<2>(dst, src, src_stride, count, packed_stride, controls, spans);
+		case 3: return gather_vertex_data_sse41<3>(dst, src, src_stride, count, packed_stride, controls, spans);
+		case 4: return gather_vertex_data_sse41<4>(dst, src, src_stride, count, packed_stride, controls, spans);
+		default: break;
+		}
+	}
+
+	gather_vertex_data_naive(dst, src, src_stride, count, spans);
+}
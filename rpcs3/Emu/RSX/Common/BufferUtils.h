@@ -4,6 +4,25 @@
 
 #include <span>
 
+namespace rsx
+{
+	// Byte range of an interleaved vertex
+	struct vertex_gather_span
+	{
+		u8 offset;
+		u8 length;
+	};
+
+	// Kernels of gather_vertex_data, automatic selects the fastest one supported by the CPU
+	enum class vertex_gather_kernel : u8
+	{
+		automatic,
+		scalar,
+		sse4_1,
+		avx512_vbmi2,
+	};
+}
+
 /*
  * If primitive mode is not supported and need to be emulated (using an index buffer) returns false.
  */
@@ -38,6 +57,14 @@ std::tuple<u32, u32, u32> write_index_array_data_to_buffer(std::span<std::byte>
  */
 void write_index_array_for_non_indexed_non_native_primitive_to_buffer(char* dst, rsx::primitive_type draw_mode, unsigned count);
 
+/**
+ * Copy count vertices of src_stride bytes, keeping only the bytes covered by spans.
+ * Spans must be sorted, must not overlap and must end within the vertex. Output vertices are tightly packed.
+ * A kernel can be forced for benchmarking, it must be supported by the CPU. The scalar loop is used if the layout is not supported by the kernel.
+ */
+void gather_vertex_data(std::byte* dst, const std::byte* src, u32 src_stride, u32 count, std::span<const rsx::vertex_gather_span> spans,
+	rsx::vertex_gather_kernel kernel = rsx::vertex_gather_kernel::automatic);
+
 // Copy and swap data in 32-bit units
 extern void(*const copy_data_swap_u32)(u32*, const u32*, u32);
 
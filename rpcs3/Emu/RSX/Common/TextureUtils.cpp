@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "Emu/Memory/vm.h"
 #include "TextureUtils.h"
+#include "texture_decode_pool.h"
 #include "../RSXThread.h"
 #include "../rsx_utils.h"
 
@@ -24,6 +25,16 @@ namespace utils
 namespace
 {
 
+// Minimum amount of data in bytes decoded by one thread
+constexpr u32 c_min_decode_band_size = 256 * 1024;
+
+// Run func(first_row, last_row) on bands of rows, large images are split across the decoder threads
+template <typename F>
+void decode_rows(u32 row_count, u32 row_size, F&& func)
+{
+	rsx::texture_decode_pool::split(row_count, std::max<u32>(c_min_decode_band_size / std::max<u32>(row_size, 1), 1), std::forward<F>(func));
+}
+
 #ifndef __APPLE__
 u16 convert_rgb655_to_rgb565(const u16 bits)
 {
@@ -181,39 +192,41 @@ struct copy_unmodified_block
 	{
 		static_assert(sizeof(T) == sizeof(U), "Type size doesn't match.");
 
+		const u32 src_pitch_in_words = src_pitch_in_block * words_per_block;
+
 		if (src_pitch_in_block == dst_pitch_in_block && !border)
 		{
 			// Fast copy
-			const auto data_length = src_pitch_in_block * words_per_block * row_count * depth;
-			std::copy_n(src.begin(), std::min<usz>({data_length, src.size(), dst.size()}), dst.begin());
+			const u32 data_length = ::narrow<u32>(std::min<usz>({usz{src_pitch_in_words} * row_count * depth, src.size(), dst.size()}));
+			const u32 row_length = std::max<u32>(src_pitch_in_words, 1);
+
+			decode_rows(utils::aligned_div(data_length, row_length), row_length * sizeof(T), [&](u32 first_row, u32 last_row)
+			{
+				const u32 offset = first_row * row_length;
+				std::copy_n(src.begin() + offset, std::min(last_row * row_length, data_length) - offset, dst.begin() + offset);
+			});
+
 			return;
 		}
 
 		const u32 width_in_words = width_in_block * words_per_block;
-		const u32 src_pitch_in_words = src_pitch_in_block * words_per_block;
 		const u32 dst_pitch_in_words = dst_pitch_in_block * words_per_block;
 
 		const u32 h_porch = border * words_per_block;
 		const u32 v_porch = src_pitch_in_words * border;
-		u32 src_offset = h_porch, dst_offset = 0;
 
-		for (int layer = 0; layer < depth; ++layer)
+		// Rows are counted across all layers
+		decode_rows(u32{row_count} * depth, width_in_words * sizeof(T), [&](u32 first_row, u32 last_row)
 		{
-			// Front
-			src_offset += v_porch;
-
-			for (int row = 0; row < row_count; ++row)
+			for (u32 row = first_row; row < last_row; ++row)
 			{
-				// NOTE: src_offset is already shifted along the border at initialization
-				std::copy_n(src.begin() + src_offset, width_in_words, dst.begin() + dst_offset);
+				const u32 layer = row / row_count;
 
-				src_offset += src_pitch_in_words;
-				dst_offset += dst_pitch_in_words;
+				// Skip front porch of the layer (and front and back porches of previous layers)
+				const u32 src_offset = h_porch + v_porch * (layer * 2 + 1) + row * src_pitch_in_words;
+				std::copy_n(src.begin() + src_offset, width_in_words, dst.begin() + row * dst_pitch_in_words);
 			}
-
-			// Back
-			src_offset += v_porch;
-		}
+		});
 	}
 };
 
@@ -226,7 +239,10 @@ struct copy_unmodified_block_swizzled
 	{
 		if (std::is_same<T, U>::value && dst_pitch_in_block == width_in_block && words_per_block == 1 && !border)
 		{
-			rsx::convert_linear_swizzle_3d<T>(src.data(), dst.data(), width_in_block, row_count, depth);
+			decode_rows(u32{row_count} * depth, width_in_block * sizeof(T), [&](u32 first_row, u32 last_row)
+			{
+				rsx::convert_linear_swizzle_3d<T>(src.data(), dst.data(), width_in_block, row_count, depth, first_row, last_row);
+			});
 		}
 		else
 		{
@@ -245,22 +261,32 @@ struct copy_unmodified_block_swizzled
 			const u32 size_in_block = padded_width * padded_height * depth * 2;
 			rsx::simple_array<U> tmp(size_in_block * words_per_block);
 
+			const u32 block_size = words_per_block * sizeof(T);
+
+			auto deswizzle = [&]<typename V>(V*)
+			{
+				decode_rows(padded_height * depth, padded_width * block_size, [&](u32 first_row, u32 last_row)
+				{
+					rsx::convert_linear_swizzle_3d<V>(src.data(), tmp.data(), padded_width, padded_height, depth, first_row, last_row);
+				});
+			};
+
 			if (words_per_block == 1) [[likely]]
 			{
-				rsx::convert_linear_swizzle_3d<T>(src.data(), tmp.data(), padded_width, padded_height, depth);
+				deswizzle(static_cast<T*>(nullptr));
 			}
 			else
 			{
-				switch (words_per_block * sizeof(T))
+				switch (block_size)
 				{
 				case 4:
-					rsx::convert_linear_swizzle_3d<u32>(src.data(), tmp.data(), padded_width, padded_height, depth);
+					deswizzle(static_cast<u32*>(nullptr));
 					break;
 				case 8:
-					rsx::convert_linear_swizzle_3d<u64>(src.data(), tmp.data(), padded_width, padded_height, depth);
+					deswizzle(static_cast<u64*>(nullptr));
 					break;
 				case 16:
-					rsx::convert_linear_swizzle_3d<u128>(src.data(), tmp.data(), padded_width, padded_height, depth);
+					deswizzle(static_cast<u128*>(nullptr));
 					break;
 				default:
 					fmt::throw_exception("Failed to decode swizzled format, words_per_block=%d, src_type_size=%d", words_per_block, sizeof(T));
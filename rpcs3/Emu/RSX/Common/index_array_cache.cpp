@@ -0,0 +1,394 @@
+#include "stdafx.h"
+#include "index_array_cache.h"
+#include "BufferUtils.h"
+
+#include "Emu/Memory/vm.h"
+#include "Emu/RSX/RSXThread.h"
+
+#include "util/vm.hpp"
+
+namespace rsx
+{
+	// Call func for each host page of the range
+	template <typename F>
+	static void for_each_page(const utils::address_range& range, F&& func)
+	{
+		const auto pages = range.to_page_range();
+
+		for (u32 page = pages.start; page - pages.start < pages.end - pages.start; page += utils::c_page_size)
+		{
+			func(page);
+		}
+	}
+
+	usz index_array_cache::key_hash::operator()(const key_type& key) const noexcept
+	{
+		u64 hash = key.address | u64{key.size} << 32;
+		hash ^= (key.restart_index | u64{key.dst_size} << 32) * 0x9e3779b97f4a7c15;
+		hash ^= (static_cast<u64>(key.type) | static_cast<u64>(key.primitive) << 8 | u64{key.restart_index_enabled} << 16) << 48;
+		return static_cast<usz>(hash ^ (hash >> 29));
+	}
+
+	void index_array_cache::drop_page_entries(std::vector<key_type>& keys, u32 page)
+	{
+		for (const key_type& key : keys)
+		{
+			const auto found = m_entries.find(key);
+
+			if (found == m_entries.end())
+			{
+				continue;
+			}
+
+			m_cached_size -= found->second.data.size();
+			m_entries.erase(found);
+
+			// Unlink the key from other pages
+			for_each_page(utils::address_range::start_length(key.address, key.size), [&](u32 other)
+			{
+				if (other == page)
+				{
+					return;
+				}
+
+				if (const auto found_page = m_pages.find(other); found_page != m_pages.end())
+				{
+					std::erase(found_page->second, key);
+
+					if (found_page->second.empty())
+					{
+						m_empty_pages.push_back(other);
+					}
+				}
+			});
+		}
+
+		keys.clear();
+	}
+
+	void index_array_cache::release_empty_pages()
+	{
+		for (u32 page : m_empty_pages)
+		{
+			if (const auto found = m_pages.find(page); found != m_pages.end() && found->second.empty())
+			{
+				// Restore the protection requested by other caches
+				utils::memory_protect(vm::base(page), utils::c_page_size, get_external_protection(page));
+				m_pages.erase(found);
+			}
+		}
+
+		m_empty_pages.clear();
+
+		if (m_pages.empty())
+		{
+			m_bounds.invalidate();
+			m_empty.release(true);
+		}
+	}
+
+	utils::protection index_array_cache::get_external_protection(u32 page) const
+	{
+		u8 prot = 0;
+
+		for (u32 i = 0; i < utils::c_page_size / 4096; i++)
+		{
+			// Use the most restrictive protection of the subpages (rw < ro < no)
+			prot = std::max(prot, m_external_protection[page / 4096 + i]);
+		}
+
+		return static_cast<utils::protection>(prot);
+	}
+
+	void index_array_cache::invalidate_pages(const utils::address_range& range, bool forget_pages)
+	{
+		if (!m_bounds.overlaps(range))
+		{
+			return;
+		}
+
+		const auto pages = range.get_intersect(m_bounds).to_page_range();
+
+		// Pages without keys are released unless they are forgotten
+		const auto drop_page = [&](std::vector<key_type>& keys, u32 page)
+		{
+			drop_page_entries(keys, page);
+
+			if (!forget_pages)
+			{
+				m_empty_pages.push_back(page);
+			}
+		};
+
+		if (static_cast<usz>(pages.length() / utils::c_page_size) > m_pages.size())
+		{
+			for (auto it = m_pages.begin(); it != m_pages.end();)
+			{
+				if (!pages.overlaps(it->first))
+				{
+					++it;
+					continue;
+				}
+
+				drop_page(it->second, it->first);
+				it = forget_pages ? m_pages.erase(it) : std::next(it);
+			}
+		}
+		else
+		{
+			for_each_page(pages, [&](u32 page)
+			{
+				if (const auto found = m_pages.find(page); found != m_pages.end())
+				{
+					drop_page(found->second, page);
+
+					if (forget_pages)
+					{
+						m_pages.erase(found);
+					}
+				}
+			});
+		}
+
+		release_empty_pages();
+	}
+
+	std::tuple<u32, u32, u32> index_array_cache::convert(const key_type& key, std::span<std::byte> dst, const std::function<bool(primitive_type)>& expands)
+	{
+		const auto convert_direct = [&]()
+		{
+			return write_index_array_data_to_buffer(dst, {vm::get_super_ptr<const std::byte>(key.address), key.size},
+				key.type, key.primitive, key.restart_index_enabled, key.restart_index, expands);
+		};
+
+		if (key.size < c_min_size || key.size > c_max_cached_size / 4)
+		{
+			return convert_direct();
+		}
+
+		const auto range = utils::address_range::start_length(key.address, key.size);
+
+		bool can_cache = true;
+
+		{
+			reader_lock lock(m_mutex);
+
+			if (const auto found = m_entries.find(key); found != m_entries.end())
+			{
+				// Source pages are still write-protected
+				std::memcpy(dst.data(), found->second.data.data(), found->second.data.size());
+				return found->second.result;
+			}
+
+			const bool is_surface = std::any_of(m_surface_ranges.begin(), m_surface_ranges.end(), [&](const utils::address_range& surface)
+			{
+				return surface.overlaps(range);
+			});
+
+			if (is_surface)
+			{
+				can_cache = false;
+			}
+			else if (!m_candidates.contains(key))
+			{
+				// Only cache conversions which are reused
+				lock.upgrade();
+
+				if (m_candidates.size() >= 0x1000)
+				{
+					m_candidates.clear();
+				}
+
+				m_candidates.insert(key);
+				can_cache = false;
+			}
+		}
+
+		if (!can_cache)
+		{
+			return convert_direct();
+		}
+
+		// Let other caches restore the data (flush GPU writes) before reading it through the unprotected view
+		for_each_page(range, [&](u32 page)
+		{
+			[[maybe_unused]] const volatile u8 touch = *vm::_ptr<const volatile u8>(std::max(page, key.address));
+		});
+
+		std::lock_guard lock(m_mutex);
+
+		for_each_page(range, [&](u32 page)
+		{
+			if (const auto found = m_page_writes.find(page); found != m_page_writes.end() && found->second >= c_max_page_writes)
+			{
+				can_cache = false;
+			}
+		});
+
+		if (!can_cache)
+		{
+			m_candidates.erase(key);
+			return convert_direct();
+		}
+
+		if (m_cached_size + dst.size() > c_max_cached_size)
+		{
+			rsx_log.trace("Index array cache: Budget exceeded, dropping %u entries", m_entries.size());
+			drop_all();
+		}
+
+		// Publish before protecting so GPU writes from other threads are not skipped
+		m_empty.release(false);
+
+		// Writes to the source fault and wait until the conversion is stored
+		for_each_page(range, [&](u32 page)
+		{
+			auto [found, inserted] = m_pages.try_emplace(page);
+
+			if (inserted)
+			{
+				utils::memory_protect(vm::base(page), utils::c_page_size, utils::protection::no);
+			}
+
+			found->second.push_back(key);
+		});
+
+		const auto result = convert_direct();
+
+		auto& entry = m_entries[key];
+		entry.data.assign(dst.begin(), dst.end());
+		entry.result = result;
+
+		m_cached_size += entry.data.size();
+		m_candidates.erase(key);
+
+		if (m_bounds.valid())
+		{
+			m_bounds.set_min_max(range.to_page_range());
+		}
+		else
+		{
+			m_bounds = range.to_page_range();
+		}
+
+		return result;
+	}
+
+	bool index_array_cache::on_access_violation(u32 address, bool is_writing, bool handled)
+	{
+		const u32 page = utils::page_start(address);
+
+		std::lock_guard lock(m_mutex);
+
+		const auto found = m_pages.find(page);
+
+		if (found == m_pages.end())
+		{
+			return false;
+		}
+
+		if (!is_writing)
+		{
+			// Allow reads, writes are still trapped
+			if (!handled)
+			{
+				utils::memory_protect(vm::base(page), utils::c_page_size, utils::protection::ro);
+			}
+
+			return true;
+		}
+
+		drop_page_entries(found->second, page);
+		m_pages.erase(found);
+		m_page_writes[page]++;
+
+		if (!handled)
+		{
+			utils::memory_protect(vm::base(page), utils::c_page_size, utils::protection::rw);
+		}
+
+		release_empty_pages();
+		return true;
+	}
+
+	void index_array_cache::invalidate_range(const utils::address_range& range, bool forget_pages)
+	{
+		std::lock_guard lock(m_mutex);
+
+		if (forget_pages)
+		{
+			// Unmapped memory is not protected by other caches anymore
+			std::memset(m_external_protection.get() + range.start / 4096, 0, range.length() / 4096);
+		}
+
+		invalidate_pages(range, forget_pages);
+	}
+
+	void index_array_cache::protect_range(const utils::address_range& range, utils::protection prot)
+	{
+		std::lock_guard lock(m_mutex);
+
+		std::memset(m_external_protection.get() + range.start / 4096, static_cast<u8>(prot), range.length() / 4096);
+
+		// Other caches change protection after the GPU wrote the memory (flush, blit destination) or before it is written
+		invalidate_pages(range, prot == utils::protection::rw);
+
+		utils::memory_protect(vm::base(range.start), range.length(), prot);
+	}
+
+	void index_array_cache::set_surface_ranges(std::vector<utils::address_range>&& ranges)
+	{
+		std::lock_guard lock(m_mutex);
+
+		for (const auto& range : ranges)
+		{
+			// Drop conversions made before the GPU started writing to the surface
+			invalidate_pages(range, false);
+		}
+
+		m_surface_ranges = std::move(ranges);
+	}
+
+	void index_array_cache::drop_all()
+	{
+		for (auto& [page, keys] : m_pages)
+		{
+			keys.clear();
+			m_empty_pages.push_back(page);
+		}
+
+		m_entries.clear();
+		m_cached_size = 0;
+
+		release_empty_pages();
+	}
+
+	void index_array_cache::clear()
+	{
+		std::lock_guard lock(m_mutex);
+
+		drop_all();
+		m_candidates.clear();
+		m_page_writes.clear();
+		m_surface_ranges.clear();
+	}
+
+	void index_array_cache::memory_protect(const utils::address_range& range, utils::protection prot)
+	{
+		if (const auto render = get_current_renderer())
+		{
+			render->index_cache.protect_range(range, prot);
+			return;
+		}
+
+		utils::memory_protect(vm::base(range.start), range.length(), prot);
+	}
+
+	void index_array_cache::notify_gpu_write(const utils::address_range& range)
+	{
+		if (const auto render = get_current_renderer(); render && !render->index_cache.empty())
+		{
+			render->index_cache.invalidate_range(range);
+		}
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Utilities/address_range.h"
+#include "Utilities/mutex.h"
+#include "Emu/RSX/gcm_enums.h"
+#include "util/vm.hpp"
+
+#include <functional>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace rsx
+{
+	// Persistent cache of converted (byteswapped, scanned and expanded) index arrays
+	// Source pages are protected while their conversions are cached, so entries survive frames until the guest writes the data
+	class index_array_cache
+	{
+	public:
+		struct key_type
+		{
+			u32 address;
+			u32 size; // Source size in bytes
+			u32 dst_size; // Converted size in bytes
+			u32 restart_index;
+			index_array_type type;
+			primitive_type primitive;
+			bool restart_index_enabled;
+
+			bool operator==(const key_type&) const = default;
+		};
+
+	private:
+		struct key_hash
+		{
+			usz operator()(const key_type& key) const noexcept;
+		};
+
+		struct entry_type
+		{
+			std::vector<std::byte> data;
+			std::tuple<u32, u32, u32> result; // min index, max index, index count
+		};
+
+		// Smaller arrays are cheaper to convert than to protect
+		static constexpr u32 c_min_size = 256;
+
+		// Pages written this many times while cached are not protected anymore
+		static constexpr u32 c_max_page_writes = 4;
+
+		// Drop everything when converted data exceeds this size
+		static constexpr usz c_max_cached_size = 64 * 1024 * 1024;
+
+		std::unordered_map<key_type, entry_type, key_hash> m_entries;
+
+		// Keys seen once, conversions are only cached when they are reused
+		std::unordered_set<key_type, key_hash> m_candidates;
+
+		// Pages protected by the cache and the keys depending on them
+		std::unordered_map<u32, std::vector<key_type>> m_pages;
+
+		// Pages which may have lost their last key, released by release_empty_pages()
+		std::vector<u32> m_empty_pages;
+
+		// Protection requested by other caches for each 4K page (utils::protection), restored when pages are released
+		std::unique_ptr<u8[]> m_external_protection = std::make_unique<u8[]>(0x100000);
+
+		// Write count of pages which were protected
+		std::unordered_map<u32, u32> m_page_writes;
+
+		// Range containing all protected pages
+		utils::address_range m_bounds;
+
+		// Set when no page is protected, mirrors m_bounds for empty() which is called without the lock
+		atomic_t<bool> m_empty = true;
+
+		// Memory written by the GPU (bound surfaces), not cached
+		std::vector<utils::address_range> m_surface_ranges;
+
+		usz m_cached_size = 0;
+
+		shared_mutex m_mutex;
+
+		void drop_page_entries(std::vector<key_type>& keys, u32 page);
+		void invalidate_pages(const utils::address_range& range, bool forget_pages);
+		void release_empty_pages();
+		utils::protection get_external_protection(u32 page) const;
+		void protect_range(const utils::address_range& range, utils::protection prot);
+		void drop_all();
+
+	public:
+		index_array_cache() = default;
+
+		index_array_cache(const index_array_cache&) = delete;
+
+		index_array_cache& operator=(const index_array_cache&) = delete;
+
+		// May be called from any thread without the lock
+		bool empty() const
+		{
+			return m_empty.load();
+		}
+
+		// Convert the guest index array described by key into dst, reusing the cached conversion when possible
+		std::tuple<u32, u32, u32> convert(const key_type& key, std::span<std::byte> dst, const std::function<bool(primitive_type)>& expands);
+
+		// Handle a fault on a protected page, handled is true if another cache already processed the violation
+		bool on_access_violation(u32 address, bool is_writing, bool handled);
+
+		// Memory was written without a fault (GPU), forget_pages must be set if the pages were unmapped or unprotected
+		void invalidate_range(const utils::address_range& range, bool forget_pages = false);
+
+		// New surfaces were bound, their memory is written by the GPU from now on
+		void set_surface_ranges(std::vector<utils::address_range>&& ranges);
+
+		// Forget all entries and statistics
+		void clear();
+
+		// Change protection on behalf of another cache, dependent entries are dropped
+		static void memory_protect(const utils::address_range& range, utils::protection prot);
+
+		// Called when the GPU writes guest memory directly (blit destinations), dependent entries are dropped
+		static void notify_gpu_write(const utils::address_range& range);
+	};
+}
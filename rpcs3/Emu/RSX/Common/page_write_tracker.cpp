@@ -0,0 +1,99 @@
+#include "stdafx.h"
+#include "page_write_tracker.h"
+
+#include "Emu/IdManager.h"
+
+namespace rsx
+{
+	page_write_tracker::page_write_tracker()
+		: m_pages(std::make_unique<atomic_t<u32>[]>(0x1'0000'0000ull >> c_page_shift))
+		, m_blocks(std::make_unique<atomic_t<u32>[]>(0x1'0000'0000ull >> c_block_shift))
+	{
+	}
+
+	u64 page_write_tracker::get_block_sum(const utils::address_range& range) const
+	{
+		u64 result = 0;
+
+		for (u32 block = range.start >> c_block_shift; block <= range.end >> c_block_shift; block++)
+		{
+			result += m_blocks[block].observe();
+		}
+
+		return result;
+	}
+
+	u64 page_write_tracker::get_page_sum(const utils::address_range& range) const
+	{
+		u64 result = 0;
+
+		for (u32 page = range.start >> c_page_shift; page <= range.end >> c_page_shift; page++)
+		{
+			result += m_pages[page].observe();
+		}
+
+		return result;
+	}
+
+	void page_write_tracker::mark(const utils::address_range& range)
+	{
+		if (!range.valid())
+		{
+			return;
+		}
+
+		// Pages first, a reader which sees the block counter change also sees the page counter change
+		for (u32 page = range.start >> c_page_shift; page <= range.end >> c_page_shift; page++)
+		{
+			m_pages[page]++;
+		}
+
+		for (u32 block = range.start >> c_block_shift; block <= range.end >> c_block_shift; block++)
+		{
+			m_blocks[block]++;
+		}
+	}
+
+	void page_write_tracker::update(const utils::address_range& range, generation& gen) const
+	{
+		if (!range.valid())
+		{
+			return;
+		}
+
+		if (const u64 blocks = get_block_sum(range); blocks != gen.blocks)
+		{
+			gen.blocks = blocks;
+			gen.pages = get_page_sum(range);
+		}
+	}
+
+	bool page_write_tracker::test(const utils::address_range& range, generation& gen) const
+	{
+		if (!range.valid())
+		{
+			return false;
+		}
+
+		const u64 blocks = get_block_sum(range);
+
+		if (blocks == gen.blocks)
+		{
+			return false;
+		}
+
+		if (get_page_sum(range) != gen.pages)
+		{
+			return true;
+		}
+
+		// Other pages of the blocks were written
+		gen.blocks = blocks;
+		return false;
+	}
+
+	page_write_tracker* page_write_tracker::get()
+	{
+		return g_fxo->try_get<page_write_tracker>();
+	}
+}
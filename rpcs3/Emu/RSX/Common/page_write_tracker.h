@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Utilities/address_range.h"
+#include "util/atomic.hpp"
+
+#include <memory>
+
+namespace rsx
+{
+	// Write tracking over the 32-bit address space, one write counter per 4K page and per block of 64 pages
+	// Pages are marked when the CPU writes them through a fault on protected memory or when they are unmapped
+	// Consumers keep the generation of the range they track and compare it later, marking a page never resets state of other consumers
+	class page_write_tracker
+	{
+		static constexpr u32 c_page_shift = 12;
+		static constexpr u32 c_block_shift = c_page_shift + 6;
+
+		std::unique_ptr<atomic_t<u32>[]> m_pages;
+		std::unique_ptr<atomic_t<u32>[]> m_blocks;
+
+		u64 get_block_sum(const utils::address_range& range) const;
+		u64 get_page_sum(const utils::address_range& range) const;
+
+	public:
+		// Sums of the write counters covering a range, must be reset when the range changes
+		struct generation
+		{
+			u64 blocks = umax;
+			u64 pages = 0;
+		};
+
+		page_write_tracker();
+
+		page_write_tracker(const page_write_tracker&) = delete;
+
+		page_write_tracker& operator=(const page_write_tracker&) = delete;
+
+		void mark(const utils::address_range& range);
+
+		// Take the current generation of the range, pages are only scanned if a block of the range was marked
+		void update(const utils::address_range& range, generation& gen) const;
+
+		// Check if a page of the range was marked since gen was taken
+		// Pages are only scanned when a block of the range was marked, gen is updated if the writes were outside of the range
+		bool test(const utils::address_range& range, generation& gen) const;
+
+		// Get the tracker of the running emulation (nullptr if the renderer was not created)
+		static page_write_tracker* get();
+	};
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "util/record_archive.hpp"
+
+namespace rsx
+{
+	// Shader cache storage (pipelines, raw and decompiled programs), see utils::record_archive
+	class shader_cache_archive final : public utils::record_archive
+	{
+	public:
+		static constexpr u64 c_magic = "RSXSHADR"_u64;
+		static constexpr u32 c_version = 2;
+
+		explicit shader_cache_archive(const std::string& path)
+			: record_archive(path, c_magic, c_version, "Shader cache")
+		{
+		}
+	};
+}
@@ -4,6 +4,7 @@
 #include "Utilities/geometry.h"
 #include "Utilities/address_range.h"
 #include "TextureUtils.h"
+#include "page_write_tracker.h"
 #include "../rsx_utils.h"
 #include "Emu/Memory/vm.h"
 
@@ -134,6 +135,7 @@ namespace rsx
 		u64 memory_hash = 0;
 #else
 		std::array<std::pair<u32, u64>, 3> memory_tag_samples;
+		page_write_tracker::generation memory_write_gen; // Generation of memory_range at the last sync
 #endif
 
 		std::vector<deferred_clipped_region<image_storage_type>> old_contents;
@@ -407,6 +409,7 @@ namespace rsx
 			const u32 internal_height = get_surface_height<rsx::surface_metrics::samples>();
 			const u32 excess = (rsx_pitch - native_pitch);
 			memory_range = rsx::address_range::start_length(base_addr, internal_height * rsx_pitch - excess);
+			memory_write_gen = {};
 		}
 
 		void sync_tag()
@@ -415,6 +418,12 @@ namespace rsx
 			{
 				e.second = *reinterpret_cast<u64*>(vm::g_sudo_addr + e.first);
 			}
+
+			if (auto pages = rsx::page_write_tracker::get())
+			{
+				// Memory contents match the surface now
+				pages->update(memory_range, memory_write_gen);
+			}
 		}
 
 		void shuffle_tag()
@@ -424,6 +433,12 @@ namespace rsx
 
 		bool test()
 		{
+			// Writes caught by page faults anywhere in the surface (the samples only catch unprotected writes to a few locations)
+			if (auto pages = rsx::page_write_tracker::get(); pages && pages->test(memory_range, memory_write_gen))
+			{
+				return false;
+			}
+
 			for (auto &e : memory_tag_samples)
 			{
 				if (e.second != *reinterpret_cast<u64*>(vm::g_sudo_addr + e.first))
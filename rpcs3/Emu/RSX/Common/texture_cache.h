@@ -3066,6 +3066,7 @@ namespace rsx
 
 			// Invalidate any cached subresources in modified range
 			notify_surface_changed(dst_range);
+			index_array_cache::notify_gpu_write(dst_range);
 
 			// What type of data is being moved?
 			const auto raster_type = src_is_render_target ? src_subres.surface->raster_type : rsx::surface_raster_type::undefined;
@@ -3264,6 +3265,8 @@ namespace rsx
 			m_unavoidable_hard_faults_this_frame.store(0u);
 			m_texture_upload_calls_this_frame.store(0u);
 			m_texture_upload_misses_this_frame.store(0u);
+			m_storage.m_range_queries_this_frame.store(0u);
+			m_storage.m_sections_visited_this_frame.store(0u);
 		}
 
 		void on_flush()
@@ -3342,6 +3345,16 @@ namespace rsx
 			return m_texture_upload_misses_this_frame;
 		}
 
+		u32 get_num_range_queries_this_frame() const
+		{
+			return m_storage.m_range_queries_this_frame;
+		}
+
+		u32 get_num_sections_visited_this_frame() const
+		{
+			return m_storage.m_sections_visited_this_frame;
+		}
+
 		u32 get_texture_upload_miss_percentage() const
 		{
 			return (m_texture_upload_calls_this_frame)? (m_texture_upload_misses_this_frame * 100 / m_texture_upload_calls_this_frame) : 0;
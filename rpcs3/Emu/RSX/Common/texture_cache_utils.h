@@ -3,6 +3,7 @@
 #include "texture_cache_types.h"
 #include "texture_cache_predictor.h"
 #include "TextureUtils.h"
+#include "index_array_cache.h"
 
 #include "Emu/Memory/vm.h"
 #include "util/vm.hpp"
@@ -30,7 +31,7 @@ namespace rsx
 		ensure(range.is_page_range());
 
 		//rsx_log.error("memory_protect(0x%x, 0x%x, %x)", static_cast<u32>(range.start), static_cast<u32>(range.length()), static_cast<u32>(prot));
-		utils::memory_protect(vm::base(range.start), range.length(), prot);
+		index_array_cache::memory_protect(range, prot);
 
 #ifdef TEXTURE_CACHE_DEBUG
 		tex_cache_checker.set_protection(range, prot);
@@ -204,6 +205,138 @@ namespace rsx
 	};
 
 
+	/**
+	 * Interval index of the sections owned by a ranged storage block
+	 * Sections are bucketed by the length of their page range and sorted by start address in each bucket,
+	 * so a query only visits the sections of each bucket starting in [range.start - max_length + 1, range.end]
+	 * NOTE: The index must not be modified while a query cursor is in use
+	 */
+	template <typename section_storage_type>
+	class ranged_storage_section_index
+	{
+	public:
+		static constexpr u32 num_buckets = 6;
+
+		struct cursor
+		{
+			u32 bucket = 0;
+			u32 pos = umax; // Position in the bucket, umax if the bucket was not searched yet
+		};
+
+	private:
+		struct entry
+		{
+			u32 start;
+			u32 end;
+			section_storage_type* section;
+		};
+
+		std::array<std::vector<entry>, num_buckets> m_buckets;
+		u32 m_size = 0;
+
+		// Max page range length of the bucket (16K, 64K, 256K, 1M, 4M, any)
+		static constexpr u32 bucket_max_length(u32 bucket)
+		{
+			return bucket + 1 < num_buckets ? 0x4000u << (bucket * 2) : u32{umax};
+		}
+
+		static constexpr u32 bucket_for(const address_range& range)
+		{
+			u32 bucket = 0;
+			while (range.length() > bucket_max_length(bucket)) bucket++;
+			return bucket;
+		}
+
+		static inline typename std::vector<entry>::iterator lower_bound(std::vector<entry>& bucket, u32 start)
+		{
+			return std::lower_bound(bucket.begin(), bucket.end(), start, FN(x.start < y));
+		}
+
+		static inline typename std::vector<entry>::const_iterator lower_bound(const std::vector<entry>& bucket, u32 start)
+		{
+			return std::lower_bound(bucket.begin(), bucket.end(), start, FN(x.start < y));
+		}
+
+	public:
+		inline u32 size() const { return m_size; }
+		inline bool empty() const { return m_size == 0; }
+
+		void insert(section_storage_type& section)
+		{
+			const auto range = section.get_section_range().to_page_range();
+			auto& bucket = m_buckets[bucket_for(range)];
+
+			// Insert after sections with the same start
+			const auto it = std::upper_bound(bucket.begin(), bucket.end(), range.start, FN(x < y.start));
+			bucket.insert(it, entry{range.start, range.end, &section});
+			m_size++;
+		}
+
+		void erase(section_storage_type& section)
+		{
+			const auto range = section.get_section_range().to_page_range();
+			auto& bucket = m_buckets[bucket_for(range)];
+
+			for (auto it = lower_bound(bucket, range.start); it != bucket.end() && it->start == range.start; ++it)
+			{
+				if (it->section == &section)
+				{
+					bucket.erase(it);
+					m_size--;
+					return;
+				}
+			}
+
+			fmt::throw_exception("Section not found in the index (range=%s)", range.str());
+		}
+
+		void clear()
+		{
+			for (auto& bucket : m_buckets)
+			{
+				bucket.clear();
+			}
+
+			m_size = 0;
+		}
+
+		// Get the next section whose page range overlaps the range, advances pos and increments visited for each section tested
+		section_storage_type* next(const address_range& range, cursor& pos, u32& visited) const
+		{
+			for (; pos.bucket < num_buckets; pos.bucket++, pos.pos = umax)
+			{
+				const auto& bucket = m_buckets[pos.bucket];
+
+				if (pos.pos == umax)
+				{
+					// Sections starting before this cannot reach range.start
+					const u32 min_start = range.start - std::min(range.start, bucket_max_length(pos.bucket) - 1);
+					pos.pos = static_cast<u32>(lower_bound(bucket, min_start) - bucket.begin());
+				}
+
+				while (pos.pos < bucket.size())
+				{
+					const entry& e = bucket[pos.pos++];
+
+					if (e.start > range.end)
+					{
+						break;
+					}
+
+					visited++;
+
+					if (e.end >= range.start)
+					{
+						return e.section;
+					}
+				}
+			}
+
+			return nullptr;
+		}
+	};
+
+
 	/**
 	 * Ranged storage
 	 */
@@ -229,10 +362,13 @@ namespace rsx
 		using unowned_iterator = typename unowned_container_type::iterator;
 		using unowned_const_iterator = typename unowned_container_type::const_iterator;
 
+		using section_index_type = ranged_storage_section_index<section_storage_type>;
+
 	private:
 		u32 index = 0;
 		address_range range = {};
 		block_container_type sections = {};
+		section_index_type section_index; // owned sections with a valid range
 		unowned_container_type unowned; // pointers to sections from other blocks that overlap this block
 		atomic_t<u32> exists_count = 0;
 		atomic_t<u32> locked_count = 0;
@@ -287,6 +423,7 @@ namespace rsx
 		inline u32 get_exists_count() const { return exists_count; }
 		inline u32 get_locked_count() const { return locked_count; }
 		inline u32 get_unreleased_count() const { return unreleased_count; }
+		inline const section_index_type& get_section_index() const { return section_index; }
 
 		/**
 		 * Utilities
@@ -321,7 +458,9 @@ namespace rsx
 			AUDIT(exists_count == 0);
 			AUDIT(unreleased_count == 0);
 			AUDIT(locked_count == 0);
+			AUDIT(section_index.empty());
 			sections.clear();
+			section_index.clear();
 		}
 
 		inline bool is_first_block() const
@@ -376,6 +515,7 @@ namespace rsx
 		{
 			AUDIT(section.valid_range());
 			AUDIT(range.overlaps(section.get_section_base()));
+			section_index.insert(section);
 			add_owned_section_overlaps(section);
 		}
 
@@ -383,6 +523,7 @@ namespace rsx
 		{
 			AUDIT(section.valid_range());
 			AUDIT(range.overlaps(section.get_section_base()));
+			section_index.erase(section);
 			remove_owned_section_overlaps(section);
 		}
 
@@ -480,6 +621,10 @@ namespace rsx
 		atomic_t<u32> m_unreleased_texture_objects = { 0 }; //Number of invalidated objects not yet freed from memory
 		atomic_t<u64> m_texture_memory_in_use = { 0 };
 
+		// Range lookup statistics
+		atomic_t<u32> m_range_queries_this_frame = { 0 };
+		atomic_t<u32> m_sections_visited_this_frame = { 0 };
+
 		// Constructor
 		ranged_storage(texture_cache_type *tex_cache) :
 			m_tex_cache(tex_cache)
@@ -683,7 +828,7 @@ namespace rsx
 		 * Ranged Iterator
 		 */
 		 // Iterator
-		template <typename T, typename unowned_iterator, typename section_iterator, typename block_type, typename parent_type>
+		template <typename T, typename unowned_iterator, typename block_type, typename parent_type>
 		class range_iterator_tmpl
 		{
 		public:
@@ -703,9 +848,10 @@ namespace rsx
 				, block(&storage.block_for(range.start))
 				, unowned_remaining(true)
 				, unowned_it(block->unowned_begin())
-				, cur_block_it(block->begin())
 				, locked_only(_locked_only)
 			{
+				block->get_storage().m_range_queries_this_frame++;
+
 				// do a "fake" iteration to ensure the internal state is consistent
 				next(false);
 			}
@@ -719,9 +865,19 @@ namespace rsx
 			bool needs_overlap_check = true;
 			bool unowned_remaining = false;
 			unowned_iterator unowned_it = {};
-			section_iterator cur_block_it = {};
+			typename block_type::section_index_type::cursor index_pos = {};
 			pointer obj = nullptr;
 			bool locked_only = false;
+			u32 visited = 0;
+
+			inline void flush_visited()
+			{
+				if (visited)
+				{
+					block->get_storage().m_sections_visited_this_frame += visited;
+					visited = 0;
+				}
+			}
 
 			inline void next(bool iterate = true)
 			{
@@ -741,8 +897,13 @@ namespace rsx
 						if (unowned_it != blk_end)
 						{
 							obj = *unowned_it;
+							visited++;
+
 							if (obj->valid_range() && (!locked_only || obj->is_locked()) && obj->overlaps(range, bounds))
+							{
+								flush_visited();
 								return;
+							}
 
 							iterate = true;
 							continue;
@@ -759,27 +920,17 @@ namespace rsx
 				// Go to next block
 				do
 				{
-					// Iterate current block
-					do
+					// Iterate sections of the current block overlapping the range (the cursor is always advanced past the current section)
+					while ((obj = block->get_section_index().next(range, index_pos, visited)))
 					{
-						auto blk_end = block->end();
-						if (iterate && cur_block_it != blk_end)
+						if (obj->valid_range() && (!locked_only || obj->is_locked()) && (!needs_overlap_check || obj->overlaps(range, bounds)))
 						{
-							++cur_block_it;
-						}
-
-						if (cur_block_it != blk_end)
-						{
-							obj = &(*cur_block_it);
-							if (obj->valid_range() && (!locked_only || obj->is_locked()) && (!needs_overlap_check || obj->overlaps(range, bounds)))
-								return;
-
-							iterate = true;
-							continue;
+							flush_visited();
+							return;
 						}
-						break;
+					}
 
-					} while (true);
+					flush_visited();
 
 					// Move to next block(s)
 					do
@@ -793,8 +944,7 @@ namespace rsx
 						}
 
 						needs_overlap_check = (block->get_end() > range.end);
-						cur_block_it = block->begin();
-						iterate = false;
+						index_pos = {};
 					} while (locked_only && block->get_locked_count() == 0); // find a block with locked sections
 
 				} while (true);
@@ -830,8 +980,8 @@ namespace rsx
 			}
 		};
 
-		using range_iterator = range_iterator_tmpl<section_storage_type, typename block_type::unowned_iterator, typename block_type::iterator, block_type, ranged_storage>;
-		using range_const_iterator = range_iterator_tmpl<const section_storage_type, typename block_type::unowned_const_iterator, typename block_type::const_iterator, const block_type, const ranged_storage>;
+		using range_iterator = range_iterator_tmpl<section_storage_type, typename block_type::unowned_iterator, block_type, ranged_storage>;
+		using range_const_iterator = range_iterator_tmpl<const section_storage_type, typename block_type::unowned_const_iterator, const block_type, const ranged_storage>;
 
 		inline range_iterator range_begin(const address_range &range, section_bounds bounds, bool locked_only = false) {
 			return range_iterator(*this, range, bounds, locked_only);
@@ -0,0 +1,180 @@
+#include "stdafx.h"
+#include "texture_decode_pool.h"
+
+#include "Emu/IdManager.h"
+
+#include "util/sysinfo.hpp"
+#include "util/asm.hpp"
+
+namespace rsx
+{
+	thread_local texture_decode_pool::decode_worker* texture_decode_pool::decode_worker::tls_this = nullptr;
+
+	void texture_decode_pool::decode_worker::operator()()
+	{
+		tls_this = this;
+
+		// Callers wait for their jobs, complete them if the thread is terminated by fmt::throw_exception
+		thread_ctrl::set_error_callback([]()
+		{
+			tls_this->fail_jobs();
+		});
+
+		for (slice = jobs.pop_all();; [&]
+		{
+			if (slice)
+			{
+				slice.pop_front();
+			}
+
+			if (slice || thread_ctrl::state() == thread_state::aborting)
+			{
+				return;
+			}
+
+			thread_ctrl::wait_on(jobs, nullptr);
+			slice = jobs.pop_all();
+		}())
+		{
+			auto* job = slice.get();
+
+			if (!job)
+			{
+				if (thread_ctrl::state() == thread_state::aborting)
+				{
+					break;
+				}
+
+				continue;
+			}
+
+			(*job->state->func)(job->begin, job->end);
+			complete(*job);
+		}
+	}
+
+	void texture_decode_pool::decode_worker::fail_jobs()
+	{
+		failed = true;
+
+		for (; slice; slice.pop_front())
+		{
+			slice->state->failed = true;
+			complete(*slice);
+		}
+
+		fail_queued();
+	}
+
+	void texture_decode_pool::decode_worker::fail_queued()
+	{
+		for (auto queued = jobs.pop_all(); queued; queued.pop_front())
+		{
+			queued->state->failed = true;
+			complete(*queued);
+		}
+	}
+
+	void texture_decode_pool::complete(const job_type& job)
+	{
+		if (!--job.state->pending)
+		{
+			job.state->pending.notify_one();
+		}
+	}
+
+	texture_decode_pool::texture_decode_pool(u32 thread_count)
+	{
+		if (thread_count == 0)
+		{
+			// Decoding is memory bound, a few threads are enough
+			thread_count = std::clamp<u32>(utils::get_thread_count() / 4, 1, 4);
+		}
+
+		for (u32 i = 1; i < thread_count; i++)
+		{
+			m_workers.emplace_back(std::make_unique<named_thread<decode_worker>>(fmt::format("Texture Decoder %u", i)));
+		}
+	}
+
+	texture_decode_pool::~texture_decode_pool()
+	{
+		// Stop workers (joins)
+		m_workers.clear();
+	}
+
+	void texture_decode_pool::run(u32 count, u32 min_band, const std::function<void(u32, u32)>& func)
+	{
+		if (!count)
+		{
+			return;
+		}
+
+		u32 workers = 0;
+
+		for (const auto& worker : m_workers)
+		{
+			workers += !worker->failed;
+		}
+
+		const u32 max_bands = std::clamp<u32>(count / std::max<u32>(min_band, 1), 1, workers + 1);
+		const u32 band_size = utils::aligned_div(count, max_bands);
+		const u32 bands = utils::aligned_div(count, band_size);
+
+		if (bands == 1)
+		{
+			func(0, count);
+			return;
+		}
+
+		job_state state{&func, bands - 1, false};
+
+		for (u32 i = 1; const auto& worker : m_workers)
+		{
+			if (i == bands)
+			{
+				break;
+			}
+
+			if (worker->failed)
+			{
+				continue;
+			}
+
+			worker->jobs.push(job_type{&state, i * band_size, std::min(count, (i + 1) * band_size)});
+			i++;
+
+			if (worker->failed)
+			{
+				// The worker was terminated and may not have seen the job
+				worker->fail_queued();
+			}
+		}
+
+		func(0, band_size);
+
+		for (u32 value = state.pending; value; value = state.pending)
+		{
+			state.pending.wait(value);
+		}
+
+		if (state.failed)
+		{
+			fmt::throw_exception("Texture decoding failed on a decoder thread");
+		}
+	}
+
+	void texture_decode_pool::split(u32 count, u32 min_band, const std::function<void(u32, u32)>& func)
+	{
+		if (count >= min_band * 2)
+		{
+			if (auto pool = g_fxo->try_get<texture_decode_pool>(); pool && !pool->m_workers.empty())
+			{
+				pool->run(count, min_band, func);
+				return;
+			}
+		}
+
+		func(0, count);
+	}
+}
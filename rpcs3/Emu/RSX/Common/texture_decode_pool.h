@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Utilities/Thread.h"
+#include "Utilities/lockless.h"
+
+#include <functional>
+
+namespace rsx
+{
+	// Worker threads used to split large texture decoding jobs in bands
+	// Bands are disjoint, so the decoded data does not depend on the number of workers or on scheduling
+	class texture_decode_pool
+	{
+		struct job_state
+		{
+			const std::function<void(u32, u32)>* func;
+			atomic_t<u32> pending;
+			atomic_t<bool> failed;
+		};
+
+		struct job_type
+		{
+			job_state* state;
+			u32 begin;
+			u32 end;
+		};
+
+		struct decode_worker
+		{
+			lf_queue<job_type> jobs;
+
+			// Jobs taken from the queue, the first one is being processed
+			lf_queue_slice<job_type> slice;
+
+			// Set when the thread is terminated by a fatal error
+			atomic_t<bool> failed = false;
+
+			static thread_local decode_worker* tls_this;
+
+			void operator()();
+
+			// Complete the jobs of the terminated worker as failed (fail_queued() may be called from other threads)
+			void fail_jobs();
+			void fail_queued();
+		};
+
+		static void complete(const job_type& job);
+
+		std::vector<std::unique_ptr<named_thread<decode_worker>>> m_workers;
+
+	public:
+		// Thread count including the calling thread, 0 selects it from the host thread count
+		explicit texture_decode_pool(u32 thread_count);
+
+		texture_decode_pool(const texture_decode_pool&) = delete;
+
+		texture_decode_pool& operator=(const texture_decode_pool&) = delete;
+
+		~texture_decode_pool();
+
+		// Split [0, count) in bands of at least min_band elements and run func(begin, end) for each band, returns when all bands are done
+		// The calling thread processes the first band
+		// A fatal error in func terminates the worker thread, the error is then raised again on the calling thread
+		void run(u32 count, u32 min_band, const std::function<void(u32, u32)>& func);
+
+		// Run func on the pool if available, or on the calling thread
+		static void split(u32 count, u32 min_band, const std::function<void(u32, u32)>& func);
+	};
+}
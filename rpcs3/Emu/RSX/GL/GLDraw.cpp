@@ -295,6 +295,8 @@ void GLGSRender::update_draw_state()
 
 void GLGSRender::load_texture_env()
 {
+	rsx::replay_profile_scope profile_scope(replay_profile.get(), &rsx::replay_profile_t::texture_cache_ticks);
+
 	// Load textures
 	gl::command_context cmd{ gl_state };
 	std::lock_guard lock(m_sampler_mutex);
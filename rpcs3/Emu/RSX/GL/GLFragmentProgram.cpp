@@ -32,7 +32,7 @@ void GLFragmentDecompilerThread::insertHeader(std::stringstream & OS)
 
 	if (device_props.has_native_half_support)
 	{
-		const auto driver_caps = gl::get_driver_caps();
+		const auto driver_caps = gl::get_decompiler_properties();
 		if (driver_caps.NV_gpu_shader5_supported)
 		{
 			OS << "#extension GL_NV_gpu_shader5: require\n";
@@ -211,10 +211,10 @@ void GLFragmentDecompilerThread::insertGlobalFunctions(std::stringstream &OS)
 	m_shader_props.require_linear_to_srgb = properties.has_pkg;
 	m_shader_props.emulate_coverage_tests = true; // g_cfg.video.antialiasing_level == msaa_level::none;
 	m_shader_props.emulate_shadow_compare = device_props.emulate_depth_compare;
-	m_shader_props.low_precision_tests = ::gl::get_driver_caps().vendor_NVIDIA;
-	m_shader_props.disable_early_discard = !::gl::get_driver_caps().vendor_NVIDIA;
+	m_shader_props.low_precision_tests = ::gl::get_decompiler_properties().vendor_NVIDIA;
+	m_shader_props.disable_early_discard = !::gl::get_decompiler_properties().vendor_NVIDIA;
 	m_shader_props.supports_native_fp16 = device_props.has_native_half_support;
-	m_shader_props.srgb_output_rounding = ::gl::get_driver_caps().vendor_NVIDIA;
+	m_shader_props.srgb_output_rounding = ::gl::get_decompiler_properties().vendor_NVIDIA;
 
 	glsl::insert_glsl_legacy_function(OS, m_shader_props);
 }
@@ -348,15 +348,13 @@ GLFragmentProgram::~GLFragmentProgram()
 	Delete();
 }
 
-void GLFragmentProgram::Decompile(const RSXFragmentProgram& prog)
+void GLFragmentProgram::Decompile(const RSXFragmentProgram& prog, rsx::decompiled_program& result)
 {
 	u32 size;
-	std::string source;
-	GLFragmentDecompilerThread decompiler(source, parr, prog, size);
+	GLFragmentDecompilerThread decompiler(result.source, parr, prog, size);
 
-	if (!g_cfg.video.disable_native_float16)
+	if (const auto driver_caps = gl::get_decompiler_properties(); driver_caps.allow_native_float16)
 	{
-		const auto driver_caps = gl::get_driver_caps();
 		decompiler.device_props.has_native_half_support = driver_caps.NV_gpu_shader5_supported || driver_caps.AMD_gpu_shader_half_float_supported;
 		decompiler.device_props.has_low_precision_rounding = driver_caps.vendor_NVIDIA;
 	}
@@ -373,12 +371,17 @@ void GLFragmentProgram::Decompile(const RSXFragmentProgram& prog)
 				PT.type == "samplerCube")
 				continue;
 
-			usz offset = atoi(PI.name.c_str() + 2);
-			FragmentConstantOffsetCache.push_back(offset);
+			const u32 offset = atoi(PI.name.c_str() + 2);
+			result.constant_offsets.push_back(offset);
 		}
 	}
+}
+
+void GLFragmentProgram::Create(const rsx::decompiled_program& program)
+{
+	FragmentConstantOffsetCache.assign(program.constant_offsets.begin(), program.constant_offsets.end());
 
-	shader.create(::glsl::program_domain::glsl_fragment_program, source);
+	shader.create(::glsl::program_domain::glsl_fragment_program, program.source);
 	id = shader.id();
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "../Program/FragmentProgramDecompiler.h"
+#include "../Program/decompiled_program_cache.h"
 #include "../Program/GLSLTypes.h"
 #include "GLHelpers.h"
 #include "glutils/program.h"
@@ -64,8 +65,12 @@ public:
 	/**
 	 * Decompile a fragment shader located in the PS3's Memory.  This function operates synchronously.
 	 * @param prog RSXShaderProgram specifying the location and size of the shader in memory
+	 * @param result Decompiler output, used to create the shader
 	 */
-	void Decompile(const RSXFragmentProgram& prog);
+	void Decompile(const RSXFragmentProgram& prog, rsx::decompiled_program& result);
+
+	/** Create the shader from the decompiler output */
+	void Create(const rsx::decompiled_program& program);
 
 private:
 	/** Deletes the shader and any stored information */
@@ -169,6 +169,20 @@ namespace gl
 		return g_driver_caps;
 	}
 
+	decompiler_properties get_decompiler_properties()
+	{
+		const auto& driver_caps = get_driver_caps();
+
+		decompiler_properties result{};
+		result.allow_native_float16 = !g_cfg.video.disable_native_float16;
+		result.NV_gpu_shader5_supported = driver_caps.NV_gpu_shader5_supported;
+		result.AMD_gpu_shader_half_float_supported = driver_caps.AMD_gpu_shader_half_float_supported;
+		result.NV_depth_buffer_float_supported = driver_caps.NV_depth_buffer_float_supported;
+		result.vendor_NVIDIA = driver_caps.vendor_NVIDIA;
+		result.vendor_INTEL = driver_caps.vendor_INTEL;
+		return result;
+	}
+
 	bool is_primitive_native(rsx::primitive_type in)
 	{
 		switch (in)
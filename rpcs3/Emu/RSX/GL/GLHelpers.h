@@ -34,6 +34,20 @@
 
 namespace gl
 {
+	// Driver capabilities and settings read by the shader decompilers
+	// The persistent decompiled program cache is keyed by their hash, decompilers must not read other driver state
+	struct decompiler_properties
+	{
+		bool allow_native_float16;
+		bool NV_gpu_shader5_supported;
+		bool AMD_gpu_shader_half_float_supported;
+		bool NV_depth_buffer_float_supported;
+		bool vendor_NVIDIA;
+		bool vendor_INTEL;
+	};
+
+	decompiler_properties get_decompiler_properties();
+
 	void enable_debugging();
 	bool is_primitive_native(rsx::primitive_type in);
 	GLenum draw_mode(rsx::primitive_type in);
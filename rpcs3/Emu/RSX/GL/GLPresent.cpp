@@ -339,10 +339,14 @@ void GLGSRender::flip(const rsx::display_flip_info_t& info)
 		const auto num_texture_upload = m_gl_texture_cache.get_texture_upload_calls_this_frame();
 		const auto num_texture_upload_miss = m_gl_texture_cache.get_texture_upload_misses_this_frame();
 		const auto texture_upload_miss_ratio = m_gl_texture_cache.get_texture_upload_miss_percentage();
+		const auto num_range_queries = m_gl_texture_cache.get_num_range_queries_this_frame();
+		const auto num_sections_visited = m_gl_texture_cache.get_num_sections_visited_this_frame();
 		m_text_printer.print_text(cmd, 4, 126, width, height, fmt::format("Unreleased textures: %7d", num_dirty_textures));
 		m_text_printer.print_text(cmd, 4, 144, width, height, fmt::format("Texture memory: %12dM", texture_memory_size));
 		m_text_printer.print_text(cmd, 4, 162, width, height, fmt::format("Flush requests: %12d  = %2d (%3d%%) hard faults, %2d unavoidable, %2d misprediction(s), %2d speculation(s)", num_flushes, num_misses, cache_miss_ratio, num_unavoidable, num_mispredict, num_speculate));
 		m_text_printer.print_text(cmd, 4, 180, width, height, fmt::format("Texture uploads: %15u (%u from CPU - %02u%%)", num_texture_upload, num_texture_upload_miss, texture_upload_miss_ratio));
+		m_text_printer.print_text(cmd, 4, 198, width, height, fmt::format("Range lookups: %17u (%u sections visited)", num_range_queries, num_sections_visited));
+		m_text_printer.print_text(cmd, 4, 216, width, height, fmt::format("ZCULL reports: %17u (%u coalesced, %u stalls avoided, %u forced syncs)", info.stats.zcull_reports_retired, info.stats.zcull_reports_coalesced, info.stats.zcull_stalls_avoided, info.stats.zcull_forced_syncs));
 	}
 
 	if (gl::debug::g_vis_texture)
@@ -6,6 +6,8 @@
 #include "../Program/ProgramStateCache.h"
 #include "../rsx_utils.h"
 
+#include "util/fnv_hash.hpp"
+
 struct GLTraits
 {
 	using vertex_program_type = GLVertexProgram;
@@ -15,15 +17,34 @@ struct GLTraits
 	using pipeline_properties = void*;
 
 	static
-	void recompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, usz /*ID*/)
+	void decompile_fragment_program(const RSXFragmentProgram &RSXFP, fragment_program_type& fragmentProgramData, rsx::decompiled_program& result)
+	{
+		fragmentProgramData.Decompile(RSXFP, result);
+	}
+
+	static
+	void decompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, rsx::decompiled_program& result)
+	{
+		vertexProgramData.Decompile(RSXVP, result);
+	}
+
+	static
+	void recompile_fragment_program(const rsx::decompiled_program& program, fragment_program_type& fragmentProgramData, usz /*ID*/)
+	{
+		fragmentProgramData.Create(program);
+	}
+
+	static
+	void recompile_vertex_program(const rsx::decompiled_program& program, vertex_program_type& vertexProgramData, usz /*ID*/)
 	{
-		fragmentProgramData.Decompile(RSXFP);
+		vertexProgramData.Create(program);
 	}
 
 	static
-	void recompile_vertex_program(const RSXVertexProgram &RSXVP, vertex_program_type& vertexProgramData, usz /*ID*/)
+	u64 get_decompiler_properties_hash()
 	{
-		vertexProgramData.Decompile(RSXVP);
+		// Everything the decompilers read from the driver
+		return rpcs3::hash_struct(gl::get_decompiler_properties());
 	}
 
 	static
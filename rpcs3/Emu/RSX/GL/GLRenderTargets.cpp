@@ -102,6 +102,8 @@ u8 rsx::internals::get_pixel_size(rsx::surface_depth_format format)
 
 void GLGSRender::init_buffers(rsx::framebuffer_creation_context context, bool /*skip_reading*/)
 {
+	rsx::replay_profile_scope profile_scope(replay_profile.get(), &rsx::replay_profile_t::surface_store_ticks);
+
 	const bool clipped_scissor = (context == rsx::framebuffer_creation_context::context_draw);
 	if (m_current_framebuffer_context == context && !m_rtts_dirty && m_draw_fbo)
 	{
@@ -104,12 +104,9 @@ namespace
 			void* ptr                  = mapping.first;
 			u32 offset_in_index_buffer = mapping.second;
 
-			std::tie(min_index, max_index, index_count) = write_index_array_data_to_buffer(
+			std::tie(min_index, max_index, index_count) = rsx::get_current_renderer()->write_index_array_data(
 				{ reinterpret_cast<std::byte*>(ptr), max_size },
-				command.raw_index_buffer, type,
-				rsx::method_registers.current_draw_clause.primitive,
-				rsx::method_registers.restart_index_enabled(),
-				rsx::method_registers.restart_index(),
+				command, type,
 				[](auto prim) { return !gl::is_primitive_native(prim); });
 
 			if (min_index >= max_index)
@@ -187,13 +184,16 @@ gl::vertex_upload_info GLGSRender::set_vertex_buffer()
 		//TODO: make vertex cache keep local data beyond frame boundaries and hook notify command
 		bool in_cache = false;
 		bool to_store = false;
-		u32  storage_address = -1;
+		uptr storage_address = -1;
 
 		if (m_vertex_layout.interleaved_blocks.size() == 1 &&
 			rsx::method_registers.current_draw_clause.command != rsx::draw_command::inlined_array)
 		{
-			const auto data_offset = (vertex_base * m_vertex_layout.interleaved_blocks[0].attribute_stride);
-			storage_address = m_vertex_layout.interleaved_blocks[0].real_offset_address + data_offset;
+			const auto& block = m_vertex_layout.interleaved_blocks[0];
+			const auto data_offset = (vertex_base * block.attribute_stride);
+
+			// Gathered uploads of the same memory contain different data
+			storage_address = (block.real_offset_address + data_offset) | (uptr{block.packing_key()} << 32);
 
 			if (auto cached = m_vertex_cache->find_vertex_range(storage_address, GL_R8UI, required.first))
 			{
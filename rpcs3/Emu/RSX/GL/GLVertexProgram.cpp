@@ -123,7 +123,7 @@ void GLVertexDecompilerThread::insertOutputs(std::stringstream& OS, const std::v
 
 void GLVertexDecompilerThread::insertMainStart(std::stringstream & OS)
 {
-	const auto& dev_caps = gl::get_driver_caps();
+	const auto dev_caps = gl::get_decompiler_properties();
 
 	glsl::shader_properties properties2{};
 	properties2.domain = glsl::glsl_vertex_program;
@@ -271,16 +271,21 @@ GLVertexProgram::~GLVertexProgram()
 	Delete();
 }
 
-void GLVertexProgram::Decompile(const RSXVertexProgram& prog)
+void GLVertexProgram::Decompile(const RSXVertexProgram& prog, rsx::decompiled_program& result)
 {
-	std::string source;
-	GLVertexDecompilerThread decompiler(prog, source, parr);
+	GLVertexDecompilerThread decompiler(prog, result.source, parr);
 	decompiler.Task();
 
-	has_indexed_constants = decompiler.properties.has_indexed_constants;
-	constant_ids = std::vector<u16>(decompiler.m_constant_ids.begin(), decompiler.m_constant_ids.end());
+	result.has_indexed_constants = decompiler.properties.has_indexed_constants;
+	result.constant_ids = std::vector<u16>(decompiler.m_constant_ids.begin(), decompiler.m_constant_ids.end());
+}
+
+void GLVertexProgram::Create(const rsx::decompiled_program& program)
+{
+	has_indexed_constants = program.has_indexed_constants;
+	constant_ids = program.constant_ids;
 
-	shader.create(::glsl::program_domain::glsl_vertex_program, source);
+	shader.create(::glsl::program_domain::glsl_vertex_program, program.source);
 	id = shader.id();
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "../Program/VertexProgramDecompiler.h"
+#include "../Program/decompiled_program_cache.h"
 #include "GLHelpers.h"
 #include "glutils/program.h"
 
@@ -62,7 +63,8 @@ public:
 	std::vector<u16> constant_ids;
 	bool has_indexed_constants;
 
-	void Decompile(const RSXVertexProgram& prog);
+	void Decompile(const RSXVertexProgram& prog, rsx::decompiled_program& result);
+	void Create(const rsx::decompiled_program& program);
 
 private:
 	void Delete();
@@ -12,6 +12,15 @@ NullGSRender::NullGSRender(utils::serial* ar) noexcept : GSRender(ar)
 
 void NullGSRender::end()
 {
+	if (replay_profile && m_rtts_dirty) [[unlikely]]
+	{
+		// There is no surface store, evaluate the framebuffer layout so replay benchmarks still account for surface setup
+		rsx::replay_profile_scope profile_scope(replay_profile.get(), &rsx::replay_profile_t::surface_store_ticks);
+
+		get_framebuffer_layout(rsx::framebuffer_creation_context::context_draw, m_framebuffer_layout);
+		m_rtts_dirty = false;
+	}
+
 	execute_nop_draw();
 	rsx::thread::end();
 }
@@ -2,6 +2,7 @@
 
 #include "RSXFragmentProgram.h"
 #include "RSXVertexProgram.h"
+#include "decompiled_program_cache.h"
 
 #include "Utilities/mutex.h"
 #include "util/logs.hpp"
@@ -92,8 +93,11 @@ namespace program_hash_util
 * - a typedef PipelineProperties to a type that encapsulate various state info relevant to program compilation (alpha test, primitive type,...)
 * - a	typedef ExtraData type that will be passed to the buildProgram function.
 * It should also contains the following function member :
-* - static void recompile_fragment_program(RSXFragmentProgram *RSXFP, FragmentProgramData& fragmentProgramData, usz ID);
-* - static void recompile_vertex_program(RSXVertexProgram *RSXVP, VertexProgramData& vertexProgramData, usz ID);
+* - static void decompile_fragment_program(const RSXFragmentProgram& RSXFP, FragmentProgramData& fragmentProgramData, rsx::decompiled_program& result);
+* - static void decompile_vertex_program(const RSXVertexProgram& RSXVP, VertexProgramData& vertexProgramData, rsx::decompiled_program& result);
+* - static void recompile_fragment_program(const rsx::decompiled_program& program, FragmentProgramData& fragmentProgramData, usz ID);
+* - static void recompile_vertex_program(const rsx::decompiled_program& program, VertexProgramData& vertexProgramData, usz ID);
+* - static u64 get_decompiler_properties_hash();
 * - static PipelineData build_program(VertexProgramData &vertexProgramData, FragmentProgramData &fragmentProgramData, const PipelineProperties &pipelineProperties, const ExtraData& extraData);
 * - static void validate_pipeline_properties(const VertexProgramData &vertexProgramData, const FragmentProgramData &fragmentProgramData, PipelineProperties& props);
 */
@@ -155,6 +159,9 @@ protected:
 
 	decompiler_callback_t notify_pipeline_compiled;
 
+	// Decompiler output stored by the shader cache
+	rsx::decompiled_program_cache m_decompiled_programs;
+
 	vertex_program_type __null_vertex_program;
 	fragment_program_type __null_fragment_program;
 	pipeline_storage_type __null_pipeline_handle;
@@ -188,7 +195,15 @@ protected:
 
 		if (recompile)
 		{
-			backend_traits::recompile_vertex_program(rsx_vp, *new_shader, m_next_id++);
+			rsx::decompiled_program program;
+
+			if (!m_decompiled_programs.load(rsx_vp, program))
+			{
+				backend_traits::decompile_vertex_program(rsx_vp, *new_shader, program);
+				m_decompiled_programs.store(rsx_vp, program);
+			}
+
+			backend_traits::recompile_vertex_program(program, *new_shader, m_next_id++);
 		}
 
 		return std::forward_as_tuple(*new_shader, false);
@@ -225,7 +240,16 @@ protected:
 		if (recompile)
 		{
 			it->first.clone_data();
-			backend_traits::recompile_fragment_program(rsx_fp, *new_shader, m_next_id++);
+
+			rsx::decompiled_program program;
+
+			if (!m_decompiled_programs.load(rsx_fp, program))
+			{
+				backend_traits::decompile_fragment_program(rsx_fp, *new_shader, program);
+				m_decompiled_programs.store(rsx_fp, program);
+			}
+
+			backend_traits::recompile_fragment_program(program, *new_shader, m_next_id++);
 		}
 
 		return std::forward_as_tuple(*new_shader, false);
@@ -406,11 +430,24 @@ public:
 
 	void fill_fragment_constants_buffer(std::span<f32> dst_buffer, const fragment_program_type& fragment_program, const RSXFragmentProgram& rsx_prog, bool sanitize = false) const;
 
+	// Load and store decompiler output in the shader cache archive (nullptr to disable)
+	void set_decompiled_program_archive(rsx::shader_cache_archive* archive)
+	{
+		m_decompiled_programs.set_archive(archive, archive ? backend_traits::get_decompiler_properties_hash() : 0);
+	}
+
+	// Get number of programs loaded from the archive and decompiled since the last call
+	std::pair<u32, u32> reset_decompiled_program_stats()
+	{
+		return m_decompiled_programs.reset_stats();
+	}
+
 	void clear()
 	{
 		std::scoped_lock lock(m_vertex_mutex, m_fragment_mutex, m_decompiler_mutex, m_pipeline_mutex);
 
 		notify_pipeline_compiled = {};
+		m_decompiled_programs.set_archive(nullptr, 0);
 		m_fragment_shader_cache.clear();
 		m_vertex_shader_cache.clear();
 		m_storage.clear();
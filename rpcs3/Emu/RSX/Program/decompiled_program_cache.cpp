@@ -0,0 +1,115 @@
+#include "stdafx.h"
+#include "decompiled_program_cache.h"
+#include "ProgramStateCache.h"
+
+#include "Emu/RSX/Common/shader_cache_archive.h"
+
+#include "util/fnv_hash.hpp"
+
+namespace rsx
+{
+	// Archive record types
+	static constexpr u32 c_vertex_program_record = "VDEC"_u32;
+	static constexpr u32 c_fragment_program_record = "FDEC"_u32;
+
+	void decompiled_program_cache::set_archive(shader_cache_archive* archive, u64 backend_properties_hash)
+	{
+		m_archive = archive;
+		m_key_seed = rpcs3::hash64(rpcs3::hash64(rpcs3::fnv_seed, c_decompiler_version), backend_properties_hash);
+	}
+
+	u64 decompiled_program_cache::get_key(const RSXVertexProgram& prog) const
+	{
+		u64 hash = rpcs3::hash64(m_key_seed, program_hash_util::vertex_program_utils::get_vertex_program_ucode_hash(prog));
+		hash = rpcs3::hash64(hash, prog.output_mask);
+		hash = rpcs3::hash64(hash, prog.texture_state.texture_dimensions);
+		hash = rpcs3::hash64(hash, prog.texture_state.multisampled_textures);
+		hash = rpcs3::hash64(hash, prog.base_address);
+		hash = rpcs3::hash64(hash, prog.entry);
+
+		for (const u32 address : prog.jump_table)
+		{
+			hash = rpcs3::hash64(hash, address);
+		}
+
+		return hash;
+	}
+
+	u64 decompiled_program_cache::get_key(const RSXFragmentProgram& prog) const
+	{
+		u64 hash = rpcs3::hash64(m_key_seed, program_hash_util::fragment_program_utils::get_fragment_program_ucode_hash(prog));
+		hash = rpcs3::hash64(hash, prog.ctrl);
+		hash = rpcs3::hash64(hash, prog.texcoord_control_mask);
+		hash = rpcs3::hash64(hash, u32{prog.two_sided_lighting});
+		hash = rpcs3::hash64(hash, prog.texture_state.texture_dimensions);
+		hash = rpcs3::hash64(hash, prog.texture_state.redirected_textures);
+		hash = rpcs3::hash64(hash, prog.texture_state.shadow_textures);
+		hash = rpcs3::hash64(hash, prog.texture_state.multisampled_textures);
+		return hash;
+	}
+
+	bool decompiled_program_cache::load(u32 type, u64 key, decompiled_program& out)
+	{
+		if (!m_archive)
+		{
+			return false;
+		}
+
+		// Only found while the archive image is mapped (shader preload)
+		const auto data = m_archive->find(type, key);
+
+		if (data.empty())
+		{
+			m_misses++;
+			return false;
+		}
+
+		utils::serial ar;
+		ar.set_reading_state(std::vector<u8>(data.begin(), data.end()));
+		ar(out);
+
+		if (!ar.is_valid() || ar.pos != data.size())
+		{
+			rsx_log.error("Shader cache: Invalid decompiled program (type=0x%x, key=0x%llx)", type, key);
+			out = {};
+			m_misses++;
+			return false;
+		}
+
+		m_hits++;
+		return true;
+	}
+
+	void decompiled_program_cache::store(u32 type, u64 key, const decompiled_program& program)
+	{
+		if (!m_archive || m_archive->contains(type, key))
+		{
+			return;
+		}
+
+		utils::serial ar;
+		ar(program);
+
+		m_archive->add(type, key, ar.data);
+	}
+
+	bool decompiled_program_cache::load(const RSXVertexProgram& prog, decompiled_program& out)
+	{
+		return load(c_vertex_program_record, get_key(prog), out);
+	}
+
+	bool decompiled_program_cache::load(const RSXFragmentProgram& prog, decompiled_program& out)
+	{
+		return load(c_fragment_program_record, get_key(prog), out);
+	}
+
+	void decompiled_program_cache::store(const RSXVertexProgram& prog, const decompiled_program& program)
+	{
+		store(c_vertex_program_record, get_key(prog), program);
+	}
+
+	void decompiled_program_cache::store(const RSXFragmentProgram& prog, const decompiled_program& program)
+	{
+		store(c_fragment_program_record, get_key(prog), program);
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "RSXFragmentProgram.h"
+#include "RSXVertexProgram.h"
+
+#include "util/atomic.hpp"
+#include "util/serialization.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace rsx
+{
+	class shader_cache_archive;
+
+	// Decompiler output, enough to create the backend shader without running the decompiler again
+	struct decompiled_program
+	{
+		// Backend resource binding
+		struct input
+		{
+			u32 domain = 0;
+			u32 type = 0;
+			u32 location = 0;
+			std::string name;
+
+			void operator()(utils::serial& ar)
+			{
+				ar(domain, type, location, name);
+			}
+		};
+
+		std::string source;
+		std::vector<input> inputs;
+
+		// Vertex programs
+		std::vector<u16> constant_ids;
+		bool has_indexed_constants = false;
+
+		// Fragment programs
+		std::vector<u32> constant_offsets;
+		std::array<u32, 4> output_color_masks{};
+
+		void operator()(utils::serial& ar)
+		{
+			ar(source, inputs, constant_ids, has_indexed_constants, constant_offsets, output_color_masks);
+		}
+	};
+
+	// Decompiled programs stored in the shader cache archive
+	// Programs are keyed by ucode hash, the state used by the decompiler and the decompiler version
+	class decompiled_program_cache
+	{
+		// Bump when the decompiler output changes to ignore programs stored by older versions
+		static constexpr u32 c_decompiler_version = 1;
+
+		shader_cache_archive* m_archive = nullptr;
+
+		// Hash of backend properties which affect the decompiler output
+		u64 m_key_seed = 0;
+
+		atomic_t<u32> m_hits = 0;
+		atomic_t<u32> m_misses = 0;
+
+		u64 get_key(const RSXVertexProgram& prog) const;
+		u64 get_key(const RSXFragmentProgram& prog) const;
+
+		bool load(u32 type, u64 key, decompiled_program& out);
+		void store(u32 type, u64 key, const decompiled_program& program);
+
+	public:
+		// The archive must outlive the program cache
+		void set_archive(shader_cache_archive* archive, u64 backend_properties_hash);
+
+		bool load(const RSXVertexProgram& prog, decompiled_program& out);
+		bool load(const RSXFragmentProgram& prog, decompiled_program& out);
+
+		void store(const RSXVertexProgram& prog, const decompiled_program& program);
+		void store(const RSXFragmentProgram& prog, const decompiled_program& program);
+
+		// Get number of programs loaded and decompiled since the last call
+		std::pair<u32, u32> reset_stats()
+		{
+			return { m_hits.exchange(0), m_misses.exchange(0) };
+		}
+	};
+}
@@ -6,7 +6,9 @@
 #include "Common/time.hpp"
 #include "Emu/Memory/vm_reservation.h"
 #include "Emu/Cell/lv2/sys_rsx.h"
+#include "Emu/perf_trace.hpp"
 #include "util/asm.hpp"
+#include "util/tsc.hpp"
 
 #include <bitset>
 
@@ -213,6 +215,28 @@ namespace rsx
 			}
 		}
 
+		std::span<const be_t<u32>> FIFO_control::get_pending_args() const
+		{
+			// Arguments can only be referenced in place with direct memory access
+			if (!m_remaining_commands || g_cfg.core.rsx_fifo_accuracy)
+			{
+				return {};
+			}
+
+			const u32 put = read_put<false>();
+
+			if (put <= m_internal_get + 4)
+			{
+				return {};
+			}
+
+			// Stay inside the IO page of the current argument
+			const u32 page_left = (0x100000 - (m_internal_get & 0xfffff)) / 4 - 1;
+			const u32 count = std::min<u32>({m_remaining_commands, (put - m_internal_get) / 4 - 1, page_left});
+
+			return {vm::_ptr<const be_t<u32>>(m_args_ptr + 4), count};
+		}
+
 		bool FIFO_control::read_unsafe(register_pair& data)
 		{
 			// Fast read with no processing, only safe inside a PACKET_BEGIN+count block
@@ -587,6 +611,9 @@ namespace rsx
 
 	void thread::run_FIFO()
 	{
+		replay_profile_t* const profile = replay_profile.get();
+		u64 profile_stamp = profile ? utils::get_tsc() : 0;
+
 		FIFO::register_pair command;
 		fifo_ctrl->read(command);
 		const auto cmd = command.reg;
@@ -602,6 +629,7 @@ namespace rsx
 				{
 					performance_counters.FIFO_idle_timestamp = rsx::uclock();
 					performance_counters.state = FIFO_state::nop;
+					perf_trace::begin("FIFO wait");
 				}
 
 				return;
@@ -612,6 +640,7 @@ namespace rsx
 				{
 					performance_counters.FIFO_idle_timestamp = rsx::uclock();
 					performance_counters.state = FIFO_state::empty;
+					perf_trace::begin("FIFO wait");
 				}
 				else
 				{
@@ -647,6 +676,7 @@ namespace rsx
 					{
 						performance_counters.FIFO_idle_timestamp = rsx::uclock();
 						sync_point_request.release(true);
+						perf_trace::begin("FIFO wait");
 					}
 
 					performance_counters.state = FIFO_state::spinning;
@@ -698,6 +728,7 @@ namespace rsx
 			state != FIFO_state::running)
 		{
 			performance_counters.state = FIFO_state::running;
+			perf_trace::end();
 
 			// Hack: Delay FIFO wake-up according to setting
 			// NOTE: The typical spin setup is a NOP followed by a jump-to-self
@@ -814,16 +845,57 @@ namespace rsx
 
 			method_registers.decode(reg, value);
 
+			if (profile) [[unlikely]]
+			{
+				const u64 stamp = utils::get_tsc();
+				profile->fifo_decode_ticks += stamp - profile_stamp;
+				profile->method_calls[reg]++;
+				profile_stamp = stamp;
+			}
+
 			if (auto method = methods[reg])
 			{
 				method(this, reg, value);
 
+				if (profile) [[unlikely]]
+				{
+					const u64 stamp = utils::get_tsc();
+					profile->method_ticks[reg] += stamp - profile_stamp;
+					profile_stamp = stamp;
+				}
+
 				if (state & cpu_flag::again)
 				{
 					method_registers.decode(reg, method_registers.register_previous_value);
 					break;
 				}
 			}
+
+			// Decode-ahead: apply the following writes of this packet in bulk while they don't need a method handler
+			if (const auto args = fifo_ctrl->get_pending_args(); !args.empty() && !capture_current_frame && !profile && !m_flattener.is_enabled())
+			{
+				const u32 inc = fifo_ctrl->get_register_inc();
+
+				u32 next = reg;
+				u32 count = 0;
+
+				for (; count < args.size(); count++)
+				{
+					next = (next + inc) & 0x3fff;
+
+					if (methods[next])
+					{
+						break;
+					}
+
+					method_registers.decode(next, args[count]);
+				}
+
+				if (count)
+				{
+					fifo_ctrl->skip_methods(count);
+				}
+			}
 		}
 		while (fifo_ctrl->read_unsafe(command));
 
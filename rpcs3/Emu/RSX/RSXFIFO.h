@@ -141,6 +141,11 @@ namespace rsx
 			void sync_get() const;
 			std::span<const u32> get_current_arg_ptr() const;
 			u32 get_remaining_args_count() const { return m_remaining_commands; }
+
+			// Decode-ahead: following arguments of the current packet which are already below PUT (fast FIFO mode only)
+			// Their registers advance by get_register_inc() from the current one, consumed arguments must be skipped with skip_methods()
+			std::span<const be_t<u32>> get_pending_args() const;
+			u32 get_register_inc() const { return m_command_inc / 4; }
 			void restore_state(u32 cmd, u32 count);
 			void inc_get(bool wait);
 
@@ -9,7 +9,10 @@
 #include "Common/texture_cache.h"
 #include "Common/surface_store.h"
 #include "Common/time.hpp"
+#include "Common/texture_decode_pool.h"
+#include "Common/page_write_tracker.h"
 #include "Capture/rsx_capture.h"
+#include "Emu/perf_trace.hpp"
 #include "rsx_methods.h"
 #include "gcm_printing.h"
 #include "RSXDisAsm.h"
@@ -21,7 +24,7 @@
 #include "Utilities/date_time.h"
 #include "Utilities/StrUtil.h"
 
-#include "util/serialization.hpp"
+#include "util/serialization_ext.hpp"
 #include "util/asm.hpp"
 
 #include <span>
@@ -75,7 +78,11 @@ bool serialize<rsx::frame_capture_data>(utils::serial& ar, rsx::frame_capture_da
 template <>
 bool serialize<rsx::frame_capture_data::memory_block_data>(utils::serial& ar, rsx::frame_capture_data::memory_block_data& o)
 {
-	return ar(o.data);
+	const bool result = ar(o.data, o.delta_base);
+
+	// Let the file handler take or release data
+	ar.breathe();
+	return result;
 }
 
 template <>
@@ -491,9 +498,19 @@ namespace rsx
 	thread::thread(utils::serial* _ar)
 		: cpu_thread(0x5555'5555)
 	{
-		g_access_violation_handler = [this](u32 address, bool is_writing)
+		g_fxo->init<rsx::page_write_tracker>();
+		auto& written_pages = g_fxo->get<rsx::page_write_tracker>();
+
+		g_access_violation_handler = [this, &written_pages](u32 address, bool is_writing)
 		{
-			return on_access_violation(address, is_writing);
+			if (is_writing)
+			{
+				// Let caches which do not protect memory (surfaces) know about the write
+				written_pages.mark(address_range::start_length(utils::page_start(address), utils::c_page_size));
+			}
+
+			const bool handled = on_access_violation(address, is_writing);
+			return index_cache.on_access_violation(address, is_writing, handled) || handled;
 		};
 
 		m_rtts_dirty = true;
@@ -504,6 +521,8 @@ namespace rsx
 
 		g_user_asked_for_frame_capture = false;
 
+		g_fxo->init<rsx::texture_decode_pool>(g_cfg.video.texture_decoding_threads_count);
+
 		if (g_cfg.misc.use_native_interface && (g_cfg.video.renderer == video_renderer::opengl || g_cfg.video.renderer == video_renderer::vulkan))
 		{
 			m_overlay_manager = g_fxo->init<rsx::overlays::display_manager>(0);
@@ -628,6 +647,11 @@ namespace rsx
 		in_begin_end = false;
 		m_frame_stats.draw_calls++;
 
+		if (replay_profile) [[unlikely]]
+		{
+			replay_profile->draw_calls++;
+		}
+
 		method_registers.current_draw_clause.post_execute_cleanup();
 
 		m_graphics_state |= rsx::pipeline_state::framebuffer_reads_dirty;
@@ -1161,6 +1185,34 @@ namespace rsx
 		return{ ptr + first * type_size, count * type_size };
 	}
 
+	std::tuple<u32, u32, u32> thread::write_index_array_data(std::span<std::byte> dst, const draw_indexed_array_command& command,
+		rsx::index_array_type type, const std::function<bool(rsx::primitive_type)>& expands)
+	{
+		const auto& clause = rsx::method_registers.current_draw_clause;
+
+		if (!command.address || g_cfg.video.disable_index_cache)
+		{
+			if (!index_cache.empty())
+			{
+				index_cache.clear();
+			}
+
+			return write_index_array_data_to_buffer(dst, command.raw_index_buffer, type, clause.primitive,
+				rsx::method_registers.restart_index_enabled(), rsx::method_registers.restart_index(), expands);
+		}
+
+		rsx::index_array_cache::key_type key{};
+		key.address = command.address;
+		key.size = ::size32(command.raw_index_buffer);
+		key.dst_size = ::size32(dst);
+		key.restart_index = rsx::method_registers.restart_index();
+		key.type = type;
+		key.primitive = clause.primitive;
+		key.restart_index_enabled = rsx::method_registers.restart_index_enabled();
+
+		return index_cache.convert(key, dst, expands);
+	}
+
 	std::variant<draw_array_command, draw_indexed_array_command, draw_inlined_array>
 	thread::get_draw_command(const rsx::rsx_state& state) const
 	{
@@ -1171,9 +1223,12 @@ namespace rsx
 
 		if (rsx::method_registers.current_draw_clause.command == rsx::draw_command::indexed)
 		{
+			const auto raw_index_buffer = get_raw_index_array(state.current_draw_clause);
+
 			return draw_indexed_array_command
 			{
-				get_raw_index_array(state.current_draw_clause)
+				raw_index_buffer,
+				element_push_buffer.empty() ? u32{vm::get_addr(raw_index_buffer.data())} : 0
 			};
 		}
 
@@ -1586,6 +1641,24 @@ namespace rsx
 		}
 
 		layout.ignore_change = false;
+
+		// Memory written by the new surfaces is not cached as index data
+		std::vector<address_range> surface_ranges;
+
+		for (const auto& index : rsx::utility::get_rtt_indexes(layout.target))
+		{
+			if (layout.color_addresses[index])
+			{
+				surface_ranges.push_back(address_range::start_length(layout.color_addresses[index], layout.actual_color_pitch[index] * layout.height * aa_factor_v));
+			}
+		}
+
+		if (layout.zeta_address)
+		{
+			surface_ranges.push_back(address_range::start_length(layout.zeta_address, layout.actual_zeta_pitch * layout.height * aa_factor_v));
+		}
+
+		index_cache.set_surface_ranges(std::move(surface_ranges));
 	}
 
 	void thread::on_framebuffer_options_changed(u32 opt)
@@ -1924,6 +1997,106 @@ namespace rsx
 		current_vertex_program.texture_state.import(current_vp_texture_state, current_vp_metadata.referenced_textures_mask);
 	}
 
+	// Bytes read by the vertex fetch of one attribute (3-component attributes are not padded)
+	static u32 get_vertex_fetch_size(vertex_base_type type, u32 size)
+	{
+		switch (type)
+		{
+		case vertex_base_type::f: return sizeof(f32) * size;
+		case vertex_base_type::s1:
+		case vertex_base_type::sf:
+		case vertex_base_type::s32k: return sizeof(u16) * size;
+		case vertex_base_type::ub:
+		case vertex_base_type::ub256: return sizeof(u8) * size;
+		case vertex_base_type::cmp: return 4;
+		default: fmt::throw_exception("Bad vertex data type (%d)!", static_cast<u8>(type));
+		}
+	}
+
+	// Only upload the referenced bytes of each vertex if the vertex program reads a small part of a large vertex
+	static void pack_interleaved_block(interleaved_range_info& block, const rsx_state& state)
+	{
+		if (block.single_vertex || !block.attribute_stride)
+		{
+			return;
+		}
+
+		std::array<std::pair<u32, u32>, rsx::limits::vertex_count> ranges;
+		u32 range_count = 0;
+
+		for (const auto& attrib : block.locations)
+		{
+			const auto& info = state.vertex_arrays_info[attrib.index];
+			const u32 start = (info.offset() & 0x7fffffff) - block.base_offset;
+			const u32 end = start + get_vertex_fetch_size(info.type(), info.size());
+
+			if (end > block.attribute_stride)
+			{
+				// Reads data of the next vertex
+				return;
+			}
+
+			ranges[range_count++] = { start, end };
+		}
+
+		std::sort(ranges.begin(), ranges.begin() + range_count);
+
+		// Merge overlapping and adjacent attributes
+		std::array<vertex_gather_span, 2> spans{};
+		u32 span_count = 0;
+		u32 span_end = 0;
+		u32 packed_stride = 0;
+
+		for (u32 i = 0; i < range_count; i++)
+		{
+			const auto [start, end] = ranges[i];
+
+			if (span_count && start <= span_end)
+			{
+				span_end = std::max(span_end, end);
+				spans[span_count - 1].length = static_cast<u8>(span_end - spans[span_count - 1].offset);
+				continue;
+			}
+
+			if (span_count == spans.size())
+			{
+				return;
+			}
+
+			spans[span_count++] = { static_cast<u8>(start), static_cast<u8>(end - start) };
+			span_end = end;
+		}
+
+		for (u32 i = 0; i < span_count; i++)
+		{
+			packed_stride += spans[i].length;
+		}
+
+		if (packed_stride * 4 > block.attribute_stride * 3u)
+		{
+			// Not worth gathering
+			return;
+		}
+
+		for (auto& attrib : block.locations)
+		{
+			const u32 start = (state.vertex_arrays_info[attrib.index].offset() & 0x7fffffff) - block.base_offset;
+
+			for (u32 i = 0, packed_offset = 0; i < span_count; packed_offset += spans[i++].length)
+			{
+				if (start >= spans[i].offset && start < spans[i].offset + spans[i].length)
+				{
+					attrib.packed_offset = static_cast<u8>(packed_offset + start - spans[i].offset);
+					break;
+				}
+			}
+		}
+
+		block.packed_stride = static_cast<u8>(packed_stride);
+		block.packed_span_count = static_cast<u8>(span_count);
+		block.packed_spans = spans;
+	}
+
 	void thread::analyse_inputs_interleaved(vertex_input_layout& result)
 	{
 		const rsx_state& state = rsx::method_registers;
@@ -2094,6 +2267,8 @@ namespace rsx
 		{
 			//Calculate real data address to be used during upload
 			info.real_offset_address = rsx::get_address(rsx::get_vertex_offset_from_base(state.vertex_data_base_offset(), info.base_offset), info.memory_location);
+
+			pack_interleaved_block(info, state);
 		}
 	}
 
@@ -2377,6 +2552,7 @@ namespace rsx
 	void thread::fill_vertex_layout_state(const vertex_input_layout& layout, u32 first_vertex, u32 vertex_count, s32* buffer, u32 persistent_offset_base, u32 volatile_offset_base)
 	{
 		std::array<s32, 16> offset_in_block = {};
+		std::array<u8, 16> packed_stride = {};
 		u32 volatile_offset = volatile_offset_base;
 		u32 persistent_offset = persistent_offset_base;
 
@@ -2414,12 +2590,19 @@ namespace rsx
 			{
 				for (const auto& attrib : block.locations)
 				{
+					if (block.packed_stride)
+					{
+						offset_in_block[attrib.index] = persistent_offset + attrib.packed_offset;
+						packed_stride[attrib.index] = block.packed_stride;
+						continue;
+					}
+
 					const u32 local_address = (rsx::method_registers.vertex_arrays_info[attrib.index].offset() & 0x7fffffff);
 					offset_in_block[attrib.index] = persistent_offset + (local_address - block.base_offset);
 				}
 
 				const auto range = block.calculate_required_range(first_vertex, vertex_count);
-				persistent_offset += block.attribute_stride * range.second;
+				persistent_offset += block.upload_stride() * range.second;
 			}
 		}
 
@@ -2522,7 +2705,7 @@ namespace rsx
 				size = info.size();
 
 				auto stride = info.stride();
-				attrib0 = stride;
+				attrib0 = packed_stride[index] ? packed_stride[index] : stride;
 
 				if (stride > 0) //when stride is 0, input is not an array but a single element
 				{
@@ -2626,9 +2809,22 @@ namespace rsx
 			{
 				auto range = block.calculate_required_range(first_vertex, vertex_count);
 
-				const u32 data_size = range.second * block.attribute_stride;
 				const u32 vertex_base = range.first * block.attribute_stride;
 
+				if (block.packed_stride)
+				{
+					const u32 src_size = range.second * block.attribute_stride;
+					rsx::reservation_lock<true, 1> rsx_lock(block.real_offset_address + vertex_base, src_size, g_cfg.video.strict_rendering_mode.get());
+
+					gather_vertex_data(reinterpret_cast<std::byte*>(persistent), vm::_ptr<const std::byte>(block.real_offset_address) + vertex_base,
+						block.attribute_stride, range.second, { block.packed_spans.data(), block.packed_span_count });
+
+					persistent += range.second * block.packed_stride;
+					continue;
+				}
+
+				const u32 data_size = range.second * block.attribute_stride;
+
 				g_fxo->get<rsx::dma_manager>().copy(persistent, vm::_ptr<char>(block.real_offset_address) + vertex_base, data_size);
 				persistent += data_size;
 			}
@@ -3119,6 +3315,9 @@ namespace rsx
 			// Pause RSX thread momentarily to handle unmapping
 			eng_lock elock(this);
 
+			index_cache.invalidate_range(address_range::start_length(address, size), true);
+			g_fxo->get<rsx::page_write_tracker>().mark(address_range::start_length(address, size));
+
 			// Queue up memory invalidation
 			std::lock_guard lock(m_mtx_task);
 			const bool existing_range_valid = m_invalidated_memory_range.valid();
@@ -3233,6 +3432,7 @@ namespace rsx
 		if (g_user_asked_for_frame_capture.exchange(false) && !capture_current_frame)
 		{
 			capture_current_frame = true;
+			capture_frames_left = g_cfg.video.capture_frame_count;
 			frame_debug.reset();
 			frame_capture.reset();
 
@@ -3245,23 +3445,22 @@ namespace rsx
 			frame_capture.replay_commands.push_back(replay_cmd);
 			capture::capture_display_tile_state(this, frame_capture.replay_commands.back());
 		}
-		else if (capture_current_frame)
+		else if (capture_current_frame && --capture_frames_left == 0)
 		{
 			capture_current_frame = false;
 
 			const std::string file_path = fs::get_config_dir() + "captures/" + Emu.GetTitleID() + "_" + date_time::current_time_narrow() + "_capture.rrc";
 
-			// todo: may want to compress this data?
-			utils::serial save_manager;
-			save_manager.reserve(0x800'0000); // 128MB
-
-			save_manager(frame_capture);
-
 			fs::pending_file temp(file_path);
 
-			if (temp.file && (temp.file.write(save_manager.data), temp.commit(false)))
+			// Stream compressed data to the file
+			utils::serial save_manager;
+			save_manager.m_file_handler = std::make_unique<utils::compressed_serialization_file_handler>(temp.file);
+
+			// The file handler discards data after a write error, the incomplete file is not committed
+			if (temp.file && save_manager(frame_capture) && !save_manager.m_failed && save_manager.m_file_handler->finalize(save_manager) && temp.commit(false))
 			{
-				rsx_log.success("Capture successful: %s", file_path);
+				rsx_log.success("Capture successful: %s (%u memory blocks)", file_path, frame_capture.memory_data_map.size());
 			}
 			else
 			{
@@ -3445,7 +3644,10 @@ namespace rsx
 		m_queued_flip.in_progress = true;
 		m_queued_flip.skip_frame |= g_cfg.video.disable_video_output && !g_cfg.video.perf_overlay.perf_overlay_enabled;
 
-		flip(m_queued_flip);
+		{
+			perf_trace::scope trace("RSX flip", buffer);
+			flip(m_queued_flip);
+		}
 
 		last_guest_flip_timestamp = rsx::uclock() - 1000000;
 		flip_status = CELL_GCM_DISPLAY_FLIP_STATUS_DONE;
@@ -16,6 +16,8 @@
 #include "Common/bitfield.hpp"
 #include "Common/profiling_timer.hpp"
 #include "Common/texture_cache_types.h"
+#include "Common/index_array_cache.h"
+#include "Common/BufferUtils.h"
 #include "Program/RSXVertexProgram.h"
 #include "Program/RSXFragmentProgram.h"
 
@@ -250,6 +252,7 @@ namespace rsx
 	struct draw_indexed_array_command
 	{
 		std::span<const std::byte> raw_index_buffer;
+		u32 address; // Guest address of the index array (0 if indices were pushed inline)
 	};
 
 	struct draw_inlined_array
@@ -263,6 +266,7 @@ namespace rsx
 		u8 index;
 		bool modulo;
 		u16 frequency;
+		u8 packed_offset = 0; // Offset in the gathered vertex
 	};
 
 	struct interleaved_range_info
@@ -274,10 +278,26 @@ namespace rsx
 		u8   memory_location = 0;
 		u8   attribute_stride = 0;
 
+		// Referenced bytes of each vertex if they are gathered on upload (packed_stride is 0 if vertices are copied as-is)
+		u8   packed_stride = 0;
+		u8   packed_span_count = 0;
+		std::array<vertex_gather_span, 2> packed_spans{};
+
 		rsx::simple_array<interleaved_attribute_t> locations;
 
 		// Check if we need to upload a full unoptimized range, i.e [0-max_index]
 		std::pair<u32, u32> calculate_required_range(u32 first, u32 count) const;
+
+		u32 upload_stride() const
+		{
+			return packed_stride ? packed_stride : attribute_stride;
+		}
+
+		// Distinguishes gathered uploads of the same memory (0 if vertices are copied as-is)
+		u32 packing_key() const
+		{
+			return packed_stride ? std::bit_cast<u32>(packed_spans) : 0;
+		}
 	};
 
 	enum attribute_buffer_placement : u8
@@ -352,7 +372,7 @@ namespace rsx
 			for (auto &block : interleaved_blocks)
 			{
 				const auto range = block.calculate_required_range(first_vertex, vertex_count);
-				mem += range.second * block.attribute_stride;
+				mem += range.second * block.upload_stride();
 			}
 
 			return mem;
@@ -392,6 +412,11 @@ namespace rsx
 		s64 textures_upload_time;
 		s64 draw_exec_time;
 		s64 flip_time;
+
+		u32 zcull_reports_retired;
+		u32 zcull_reports_coalesced;   // Retired writes skipped because a later write replaced them
+		u32 zcull_stalls_avoided;      // Report reads satisfied without forcing the backend to sync
+		u32 zcull_forced_syncs;
 	};
 
 	struct display_flip_info_t
@@ -654,6 +679,13 @@ namespace rsx
 		vm::ptr<void(u32)> queue_handler = vm::null;
 		atomic_t<u64> vblank_count{0};
 		bool capture_current_frame = false;
+		u32 capture_frames_left = 0;
+
+		// FIFO timing for replay benchmarks (set by the replay thread while the FIFO is idle)
+		std::unique_ptr<replay_profile_t> replay_profile;
+
+		// Converted index arrays
+		rsx::index_array_cache index_cache;
 
 		u64 vblank_at_flip = umax;
 		u64 flip_notification_count = 0;
@@ -738,6 +770,10 @@ namespace rsx
 
 		std::span<const std::byte> get_raw_index_array(const draw_clause& draw_indexed_clause) const;
 
+		// Convert the current index array into dst (see write_index_array_data_to_buffer), conversions of guest memory are cached
+		std::tuple<u32, u32, u32> write_index_array_data(std::span<std::byte> dst, const draw_indexed_array_command& command,
+			rsx::index_array_type type, const std::function<bool(rsx::primitive_type)>& expands);
+
 		std::variant<draw_array_command, draw_indexed_array_command, draw_inlined_array>
 		get_draw_command(const rsx::rsx_state& state) const;
 
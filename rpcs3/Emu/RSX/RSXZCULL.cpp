@@ -328,24 +328,60 @@ namespace rsx
 			report->store({ timestamp, value, 0 });
 		}
 
-		void ZCULL_control::write(queued_report_write* writer, u64 timestamp, u32 value)
+		void ZCULL_control::defer_write(queued_report_write* writer, u32 value)
 		{
-			write(writer->sink, timestamp, writer->type, value);
-			on_report_completed(writer->sink);
+			m_retired_writes.push_back({ writer->sink, writer->type, value, true });
 
 			for (auto& addr : writer->sink_alias)
 			{
-				write(addr, timestamp, writer->type, value);
+				m_retired_writes.push_back({ addr, writer->type, value, false });
 			}
 		}
 
+		void ZCULL_control::flush_retired_writes(::rsx::thread* ptimer)
+		{
+			if (m_retired_writes.empty())
+			{
+				return;
+			}
+
+			const u64 timestamp = ptimer->timestamp();
+			auto& stats = ptimer->get_stats();
+
+			// Later writes overwrite earlier ones, walk backwards and skip addresses which were already written
+			for (auto It = m_retired_writes.rbegin(); It != m_retired_writes.rend(); ++It)
+			{
+				if (m_flushed_sinks.insert(It->sink).second)
+				{
+					write(It->sink, timestamp, It->type, It->value);
+				}
+				else
+				{
+					stats.zcull_reports_coalesced++;
+				}
+			}
+
+			// Release the pages once the data is in place
+			for (const auto& entry : m_retired_writes)
+			{
+				if (entry.completes_report)
+				{
+					on_report_completed(entry.sink);
+					stats.zcull_reports_retired++;
+				}
+			}
+
+			m_retired_writes.clear();
+			m_flushed_sinks.clear();
+		}
+
 		void ZCULL_control::retire(::rsx::thread* ptimer, queued_report_write* writer, u32 result)
 		{
 			if (!writer->forwarder)
 			{
 				// No other queries in the chain, write result
 				const auto value = (writer->type == CELL_GCM_ZPASS_PIXEL_CNT) ? m_statistics_map[writer->counter_tag].result : result;
-				write(writer, ptimer->timestamp(), value);
+				defer_write(writer, value);
 			}
 
 			if (writer->query && writer->query->sync_tag == ptimer->cond_render_ctrl.eval_sync_tag)
@@ -361,6 +397,7 @@ namespace rsx
 					// Eval was inserted while ZCULL was active but not enqueued to write to memory yet
 					// write(addr) -> enable_zpass_stats -> eval_condition -> write(addr)
 					// In this case, use what already exists in memory, not the current counter
+					flush_retired_writes(ptimer);
 					eval_failed = (vm::_ref<CellGcmReportData>(writer->sink).value == 0u);
 				}
 
@@ -388,6 +425,8 @@ namespace rsx
 				return;
 			}
 
+			ptimer->get_stats().zcull_forced_syncs++;
+
 			// Quick reverse scan to push commands ahead of time
 			for (auto It = m_pending_writes.rbegin(); It != m_pending_writes.rend(); ++It)
 			{
@@ -440,6 +479,8 @@ namespace rsx
 				processed++;
 			}
 
+			flush_retired_writes(ptimer);
+
 			if (!has_unclaimed)
 			{
 				ensure(processed == m_pending_writes.size());
@@ -534,6 +575,11 @@ namespace rsx
 				}
 			}
 
+			retire_queue(ptimer, sync_address);
+		}
+
+		void ZCULL_control::retire_queue(::rsx::thread* ptimer, u32 sync_address)
+		{
 			u32 stat_tag_to_remove = m_statistics_tag_id;
 			u32 processed = 0;
 			for (auto& writer : m_pending_writes)
@@ -595,6 +641,8 @@ namespace rsx
 			if (stat_tag_to_remove != m_statistics_tag_id)
 				m_statistics_map.erase(stat_tag_to_remove);
 
+			flush_retired_writes(ptimer);
+
 			if (processed)
 			{
 				auto remaining = m_pending_writes.size() - processed;
@@ -690,6 +738,17 @@ namespace rsx
 					}
 				}
 
+				// Retire everything whose results are already available, this often includes the requested report
+				retire_queue(ptimer, 0);
+
+				if (!query->pending)
+				{
+					ptimer->get_stats().zcull_stalls_avoided++;
+					return result_none;
+				}
+
+				ptimer->get_stats().zcull_forced_syncs++;
+
 				// There can be multiple queries all writing to the same address, loop to flush all of them
 				while (query->pending)
 				{
@@ -704,6 +763,21 @@ namespace rsx
 		flags32_t ZCULL_control::read_barrier(class ::rsx::thread* ptimer, u32 memory_address, occlusion_query_info* query)
 		{
 			// Called by cond render control. Internal RSX usage, do not disable optimizations
+			if (!query->pending)
+			{
+				return result_none;
+			}
+
+			retire_queue(ptimer, 0);
+
+			if (!query->pending)
+			{
+				ptimer->get_stats().zcull_stalls_avoided++;
+				return result_none;
+			}
+
+			ptimer->get_stats().zcull_forced_syncs++;
+
 			while (query->pending)
 			{
 				update(ptimer, memory_address);
@@ -9,6 +9,7 @@
 #include <vector>
 #include <stack>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace rsx
 {
@@ -52,6 +53,15 @@ namespace rsx
 			std::vector<vm::addr_t> sink_alias;   // Aliased memory addresses
 		};
 
+		// Report write retired by the current pass
+		struct retired_report_write
+		{
+			vm::addr_t sink;
+			u32 type;
+			u32 value;
+			bool completes_report; // Primary sink of the report (not an alias)
+		};
+
 		struct query_search_result
 		{
 			bool found;
@@ -128,6 +138,10 @@ namespace rsx
 			std::vector<queued_report_write> m_pending_writes{};
 			std::unordered_map<u32, query_stat_counter> m_statistics_map{};
 
+			// Writes retired in the current pass, flushed to memory once the pass is done
+			std::vector<retired_report_write> m_retired_writes{};
+			std::unordered_set<u32> m_flushed_sinks{};
+
 			// Enables/disables the ZCULL unit
 			void set_active(class ::rsx::thread* ptimer, bool state, bool flush_queue);
 
@@ -142,11 +156,19 @@ namespace rsx
 
 			// Write report to memory
 			void write(vm::addr_t sink, u64 timestamp, u32 type, u32 value);
-			void write(queued_report_write* writer, u64 timestamp, u32 value);
+
+			// Queue report write until the end of the current pass
+			void defer_write(queued_report_write* writer, u32 value);
+
+			// Write all deferred reports, only the last write to each address is performed
+			void flush_retired_writes(class ::rsx::thread* ptimer);
 
 			// Retire operation
 			void retire(class ::rsx::thread* ptimer, queued_report_write* writer, u32 result);
 
+			// Retire queued writes in order while results are available, or until sync_address is written (forcing reads)
+			void retire_queue(class ::rsx::thread* ptimer, u32 sync_address);
+
 		public:
 
 			ZCULL_control();
@@ -201,6 +201,36 @@ namespace vk
 		return success;
 	}
 
+	std::vector<rsx::decompiled_program::input> export_program_inputs(const std::vector<glsl::program_input>& inputs)
+	{
+		std::vector<rsx::decompiled_program::input> result;
+		result.reserve(inputs.size());
+
+		for (const auto& in : inputs)
+		{
+			result.push_back({ static_cast<u32>(in.domain), static_cast<u32>(in.type), in.location, in.name });
+		}
+
+		return result;
+	}
+
+	std::vector<glsl::program_input> import_program_inputs(const std::vector<rsx::decompiled_program::input>& inputs)
+	{
+		std::vector<glsl::program_input> result;
+		result.reserve(inputs.size());
+
+		for (const auto& in : inputs)
+		{
+			glsl::program_input& dst = result.emplace_back();
+			dst.domain = static_cast<program_domain>(in.domain);
+			dst.type = static_cast<glsl::program_input_type>(in.type);
+			dst.location = in.location;
+			dst.name = in.name;
+		}
+
+		return result;
+	}
+
 	void initialize_compiler_context()
 	{
 		glslang::InitializeProcess();
@@ -1,5 +1,7 @@
 #pragma once
 #include "../Program/GLSLTypes.h"
+#include "../Program/decompiled_program_cache.h"
+#include "VKProgramPipeline.h"
 
 namespace vk
 {
@@ -8,6 +10,10 @@ namespace vk
 	int get_varying_register_location(std::string_view varying_register_name);
 	bool compile_glsl_to_spv(std::string& shader, program_domain domain, std::vector<u32> &spv);
 
+	// Convert program inputs to and from the form stored in the shader cache
+	std::vector<rsx::decompiled_program::input> export_program_inputs(const std::vector<glsl::program_input>& inputs);
+	std::vector<glsl::program_input> import_program_inputs(const std::vector<rsx::decompiled_program::input>& inputs);
+
 	void initialize_compiler_context();
 	void finalize_compiler_context();
 }
@@ -203,6 +203,8 @@ void VKGSRender::update_draw_state()
 
 void VKGSRender::load_texture_env()
 {
+	rsx::replay_profile_scope profile_scope(replay_profile.get(), &rsx::replay_profile_t::texture_cache_ticks);
+
 	// Load textures
 	bool check_for_cyclic_refs = false;
 	auto check_surface_cache_sampler = [&](auto descriptor, const auto& tex)
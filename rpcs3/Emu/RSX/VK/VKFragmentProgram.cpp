@@ -268,12 +268,12 @@ void VKFragmentDecompilerThread::insertGlobalFunctions(std::stringstream &OS)
 	m_shader_props.require_texture_expand = properties.has_exp_tex_op;
 	m_shader_props.require_srgb_to_linear = properties.has_upg;
 	m_shader_props.require_linear_to_srgb = properties.has_pkg;
-	m_shader_props.emulate_coverage_tests = g_cfg.video.antialiasing_level == msaa_level::none;
+	m_shader_props.emulate_coverage_tests = vk::get_decompiler_properties().emulate_coverage_tests;
 	m_shader_props.emulate_shadow_compare = device_props.emulate_depth_compare;
 	m_shader_props.low_precision_tests = device_props.has_low_precision_rounding;
-	m_shader_props.disable_early_discard = vk::get_driver_vendor() != vk::driver_vendor::NVIDIA;
+	m_shader_props.disable_early_discard = !vk::get_decompiler_properties().vendor_NVIDIA;
 	m_shader_props.supports_native_fp16 = device_props.has_native_half_support;
-	m_shader_props.srgb_output_rounding = vk::get_driver_vendor() == vk::driver_vendor::NVIDIA;
+	m_shader_props.srgb_output_rounding = vk::get_decompiler_properties().vendor_NVIDIA;
 
 	glsl::insert_glsl_legacy_function(OS, m_shader_props);
 }
@@ -400,7 +400,7 @@ void VKFragmentDecompilerThread::insertMainEnd(std::stringstream & OS)
 
 void VKFragmentDecompilerThread::Task()
 {
-	m_binding_table = vk::g_render_device->get_pipeline_binding_table();
+	m_binding_table = vk::get_decompiler_properties().binding_table;
 	m_shader = Decompile();
 	vk_prog->SetInputs(inputs);
 }
@@ -412,23 +412,20 @@ VKFragmentProgram::~VKFragmentProgram()
 	Delete();
 }
 
-void VKFragmentProgram::Decompile(const RSXFragmentProgram& prog)
+void VKFragmentProgram::Decompile(const RSXFragmentProgram& prog, rsx::decompiled_program& result)
 {
 	u32 size;
-	std::string source;
-	VKFragmentDecompilerThread decompiler(source, parr, prog, size, *this);
+	VKFragmentDecompilerThread decompiler(result.source, parr, prog, size, *this);
 
-	const auto pdev = vk::get_current_renderer();
-	if (!g_cfg.video.disable_native_float16)
-	{
-		decompiler.device_props.has_native_half_support = pdev->get_shader_types_support().allow_float16;
-	}
-
-	decompiler.device_props.emulate_depth_compare = !pdev->get_formats_support().d24_unorm_s8;
-	decompiler.device_props.has_low_precision_rounding = vk::get_driver_vendor() == vk::driver_vendor::NVIDIA;
+	const auto props = vk::get_decompiler_properties();
+	decompiler.device_props.has_native_half_support = props.allow_native_float16;
+	decompiler.device_props.emulate_depth_compare = !props.d24_unorm_s8;
+	decompiler.device_props.has_low_precision_rounding = props.vendor_NVIDIA;
 	decompiler.Task();
 
-	shader.create(::glsl::program_domain::glsl_fragment_program, source);
+	// The decompiler fills the outputs and inputs of this program
+	result.output_color_masks = output_color_masks;
+	result.inputs = vk::export_program_inputs(uniforms);
 
 	for (const ParamType& PT : decompiler.m_parr.params[PF_PARAM_UNIFORM])
 	{
@@ -440,12 +437,21 @@ void VKFragmentProgram::Decompile(const RSXFragmentProgram& prog)
 				PT.type == "samplerCube")
 				continue;
 
-			usz offset = atoi(PI.name.c_str() + 2);
-			FragmentConstantOffsetCache.push_back(offset);
+			const u32 offset = atoi(PI.name.c_str() + 2);
+			result.constant_offsets.push_back(offset);
 		}
 	}
 }
 
+void VKFragmentProgram::Create(const rsx::decompiled_program& program)
+{
+	output_color_masks = program.output_color_masks;
+	uniforms = vk::import_program_inputs(program.inputs);
+	FragmentConstantOffsetCache.assign(program.constant_offsets.begin(), program.constant_offsets.end());
+
+	shader.create(::glsl::program_domain::glsl_fragment_program, program.source);
+}
+
 void VKFragmentProgram::Compile()
 {
 	if (g_cfg.video.log_programs)
@@ -2294,6 +2294,8 @@ void VKGSRender::close_and_submit_command_buffer(vk::fence* pFence, VkSemaphore
 
 void VKGSRender::prepare_rtts(rsx::framebuffer_creation_context context)
 {
+	rsx::replay_profile_scope profile_scope(replay_profile.get(), &rsx::replay_profile_t::surface_store_ticks);
+
 	const bool clipped_scissor = (context == rsx::framebuffer_creation_context::context_draw);
 	if (m_current_framebuffer_context == context && !m_rtts_dirty && m_draw_fbo)
 	{
@@ -218,6 +218,19 @@ namespace vk
 		return g_drv_emulate_cond_render;
 	}
 
+	decompiler_properties get_decompiler_properties()
+	{
+		decompiler_properties result{};
+		result.binding_table = g_render_device->get_pipeline_binding_table();
+		result.allow_native_float16 = !g_cfg.video.disable_native_float16 && g_render_device->get_shader_types_support().allow_float16;
+		result.allow_float64 = g_render_device->get_shader_types_support().allow_float64;
+		result.d24_unorm_s8 = g_render_device->get_formats_support().d24_unorm_s8;
+		result.emulate_conditional_rendering = g_drv_emulate_cond_render;
+		result.emulate_coverage_tests = g_cfg.video.antialiasing_level == msaa_level::none;
+		result.vendor_NVIDIA = g_driver_vendor == driver_vendor::NVIDIA;
+		return result;
+	}
+
 	void raise_status_interrupt(runtime_state status)
 	{
 		g_runtime_state |= status;
@@ -12,6 +12,7 @@
 
 #include "VulkanAPI.h"
 #include "vkutils/chip_class.h"
+#include "vkutils/pipeline_binding_table.h"
 #include "Utilities/geometry.h"
 #include "Emu/RSX/Common/TextureUtils.h"
 #include "Emu/RSX/rsx_utils.h"
@@ -47,6 +48,21 @@ namespace vk
 	bool emulate_conditional_rendering();
 	VkFlags get_heap_compatible_buffer_types();
 
+	// Device properties and settings read by the shader decompilers
+	// The persistent decompiled program cache is keyed by their hash, decompilers must not read other device state
+	struct decompiler_properties
+	{
+		pipeline_binding_table binding_table;
+		bool allow_native_float16;
+		bool allow_float64;
+		bool d24_unorm_s8;
+		bool emulate_conditional_rendering;
+		bool emulate_coverage_tests;
+		bool vendor_NVIDIA;
+	};
+
+	decompiler_properties get_decompiler_properties();
+
 	// Sync helpers around vkQueueSubmit
 	void acquire_global_submit_lock();
 	void release_global_submit_lock();
@@ -778,11 +778,15 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 			const auto num_texture_upload = m_texture_cache.get_texture_upload_calls_this_frame();
 			const auto num_texture_upload_miss = m_texture_cache.get_texture_upload_misses_this_frame();
 			const auto texture_upload_miss_ratio = m_texture_cache.get_texture_upload_miss_percentage();
+			const auto num_range_queries = m_texture_cache.get_num_range_queries_this_frame();
+			const auto num_sections_visited = m_texture_cache.get_num_sections_visited_this_frame();
 			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 4, 144, direct_fbo->width(), direct_fbo->height(), fmt::format("Unreleased textures: %8d", num_dirty_textures));
 			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 4, 162, direct_fbo->width(), direct_fbo->height(), fmt::format("Texture cache memory: %7dM", texture_memory_size));
 			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 4, 180, direct_fbo->width(), direct_fbo->height(), fmt::format("Temporary texture memory: %3dM", tmp_texture_memory_size));
 			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 4, 198, direct_fbo->width(), direct_fbo->height(), fmt::format("Flush requests: %13d  = %2d (%3d%%) hard faults, %2d unavoidable, %2d misprediction(s), %2d speculation(s)", num_flushes, num_misses, cache_miss_ratio, num_unavoidable, num_mispredict, num_speculate));
 			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 4, 216, direct_fbo->width(), direct_fbo->height(), fmt::format("Texture uploads: %14u (%u from CPU - %02u%%)", num_texture_upload, num_texture_upload_miss, texture_upload_miss_ratio));
+			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 4, 234, direct_fbo->width(), direct_fbo->height(), fmt::format("Range lookups: %16u (%u sections visited)", num_range_queries, num_sections_visited));
+			m_text_writer->print_text(*m_current_command_buffer, *direct_fbo, 4, 252, direct_fbo->width(), direct_fbo->height(), fmt::format("ZCULL reports: %16u (%u coalesced, %u stalls avoided, %u forced syncs)", info.stats.zcull_reports_retired, info.stats.zcull_reports_coalesced, info.stats.zcull_stalls_avoided, info.stats.zcull_forced_syncs));
 		}
 
 		direct_fbo->release();
@@ -3,6 +3,9 @@
 #include "VKFragmentProgram.h"
 #include "VKRenderPass.h"
 #include "VKPipelineCompiler.h"
+#include "VKHelpers.h"
+#include "vkutils/device.h"
+#include "Emu/system_config.h"
 #include "../Program/ProgramStateCache.h"
 
 #include "util/fnv_hash.hpp"
@@ -18,21 +21,40 @@ namespace vk
 		using pipeline_properties = vk::pipeline_props;
 
 		static
-			void recompile_fragment_program(const RSXFragmentProgram& RSXFP, fragment_program_type& fragmentProgramData, usz ID)
+			void decompile_fragment_program(const RSXFragmentProgram& RSXFP, fragment_program_type& fragmentProgramData, rsx::decompiled_program& result)
 		{
-			fragmentProgramData.Decompile(RSXFP);
+			fragmentProgramData.Decompile(RSXFP, result);
+		}
+
+		static
+			void decompile_vertex_program(const RSXVertexProgram& RSXVP, vertex_program_type& vertexProgramData, rsx::decompiled_program& result)
+		{
+			vertexProgramData.Decompile(RSXVP, result);
+		}
+
+		static
+			void recompile_fragment_program(const rsx::decompiled_program& program, fragment_program_type& fragmentProgramData, usz ID)
+		{
+			fragmentProgramData.Create(program);
 			fragmentProgramData.id = static_cast<u32>(ID);
 			fragmentProgramData.Compile();
 		}
 
 		static
-			void recompile_vertex_program(const RSXVertexProgram& RSXVP, vertex_program_type& vertexProgramData, usz ID)
+			void recompile_vertex_program(const rsx::decompiled_program& program, vertex_program_type& vertexProgramData, usz ID)
 		{
-			vertexProgramData.Decompile(RSXVP);
+			vertexProgramData.Create(program);
 			vertexProgramData.id = static_cast<u32>(ID);
 			vertexProgramData.Compile();
 		}
 
+		static
+			u64 get_decompiler_properties_hash()
+		{
+			// Everything the decompilers read from the device
+			return rpcs3::hash_struct(vk::get_decompiler_properties());
+		}
+
 		static
 			void validate_pipeline_properties(const VKVertexProgram&, const VKFragmentProgram& fp, vk::pipeline_props& properties)
 		{
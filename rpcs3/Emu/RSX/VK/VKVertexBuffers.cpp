@@ -163,12 +163,9 @@ namespace
 			* Upload index (and expands it if primitive type is not natively supported).
 			*/
 			u32 min_index, max_index;
-			std::tie(min_index, max_index, index_count) = write_index_array_data_to_buffer(
+			std::tie(min_index, max_index, index_count) = rsx::get_current_renderer()->write_index_array_data(
 				dst,
-				command.raw_index_buffer, index_type,
-				rsx::method_registers.current_draw_clause.primitive,
-				rsx::method_registers.restart_index_enabled(),
-				rsx::method_registers.restart_index(),
+				command, index_type,
 				[](auto prim) { return !vk::is_primitive_native(prim); });
 
 			if (min_index >= max_index)
@@ -252,13 +249,16 @@ vk::vertex_upload_info VKGSRender::upload_vertex_data()
 		//TODO: make vertex cache keep local data beyond frame boundaries and hook notify command
 		bool in_cache = false;
 		bool to_store = false;
-		u32  storage_address = -1;
+		uptr storage_address = -1;
 
 		if (m_vertex_layout.interleaved_blocks.size() == 1 &&
 			rsx::method_registers.current_draw_clause.command != rsx::draw_command::inlined_array)
 		{
-			const auto data_offset = (vertex_base * m_vertex_layout.interleaved_blocks[0].attribute_stride);
-			storage_address = m_vertex_layout.interleaved_blocks[0].real_offset_address + data_offset;
+			const auto& block = m_vertex_layout.interleaved_blocks[0];
+			const auto data_offset = (vertex_base * block.attribute_stride);
+
+			// Gathered uploads of the same memory contain different data
+			storage_address = (block.real_offset_address + data_offset) | (uptr{block.packing_key()} << 32);
 
 			if (auto cached = m_vertex_cache->find_vertex_range(storage_address, VK_FORMAT_R8_UINT, required.first))
 			{
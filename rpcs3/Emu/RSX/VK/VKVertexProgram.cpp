@@ -206,8 +206,8 @@ void VKVertexDecompilerThread::insertMainStart(std::stringstream & OS)
 	properties2.domain = glsl::glsl_vertex_program;
 	properties2.require_lit_emulation = properties.has_lit_op;
 	properties2.emulate_zclip_transform = true;
-	properties2.emulate_depth_clip_only = vk::g_render_device->get_shader_types_support().allow_float64;
-	properties2.low_precision_tests = vk::get_driver_vendor() == vk::driver_vendor::NVIDIA;
+	properties2.emulate_depth_clip_only = vk::get_decompiler_properties().allow_float64;
+	properties2.low_precision_tests = vk::get_decompiler_properties().vendor_NVIDIA;
 
 	glsl::insert_glsl_legacy_function(OS, properties2);
 	glsl::insert_vertex_input_fetch(OS, glsl::glsl_rules_spirv);
@@ -331,8 +331,9 @@ void VKVertexDecompilerThread::insertMainEnd(std::stringstream & OS)
 
 void VKVertexDecompilerThread::Task()
 {
-	m_device_props.emulate_conditional_rendering = vk::emulate_conditional_rendering();
-	m_binding_table = vk::g_render_device->get_pipeline_binding_table();
+	const auto props = vk::get_decompiler_properties();
+	m_device_props.emulate_conditional_rendering = props.emulate_conditional_rendering;
+	m_binding_table = props.binding_table;
 
 	m_shader = Decompile();
 	vk_prog->SetInputs(inputs);
@@ -345,16 +346,23 @@ VKVertexProgram::~VKVertexProgram()
 	Delete();
 }
 
-void VKVertexProgram::Decompile(const RSXVertexProgram& prog)
+void VKVertexProgram::Decompile(const RSXVertexProgram& prog, rsx::decompiled_program& result)
 {
-	std::string source;
-	VKVertexDecompilerThread decompiler(prog, source, parr, *this);
+	VKVertexDecompilerThread decompiler(prog, result.source, parr, *this);
 	decompiler.Task();
 
-	has_indexed_constants = decompiler.properties.has_indexed_constants;
-	constant_ids = std::vector<u16>(decompiler.m_constant_ids.begin(), decompiler.m_constant_ids.end());
+	result.has_indexed_constants = decompiler.properties.has_indexed_constants;
+	result.constant_ids = std::vector<u16>(decompiler.m_constant_ids.begin(), decompiler.m_constant_ids.end());
+	result.inputs = vk::export_program_inputs(uniforms);
+}
+
+void VKVertexProgram::Create(const rsx::decompiled_program& program)
+{
+	has_indexed_constants = program.has_indexed_constants;
+	constant_ids = program.constant_ids;
+	uniforms = vk::import_program_inputs(program.inputs);
 
-	shader.create(::glsl::program_domain::glsl_vertex_program, source);
+	shader.create(::glsl::program_domain::glsl_vertex_program, program.source);
 }
 
 void VKVertexProgram::Compile()
@@ -7,6 +7,7 @@
 #include "Emu/cache_utils.hpp"
 #include "Program/ProgramStateCache.h"
 #include "Common/texture_cache_checker.h"
+#include "Common/shader_cache_archive.h"
 #include "Overlays/Shaders/shader_loading_dialog.h"
 
 #include <chrono>
@@ -54,10 +55,17 @@ namespace rsx
 			pipeline_storage_type pipeline_properties;
 		};
 
+		// Archive record types
+		static constexpr u32 c_pipeline_record = "PIPE"_u32;
+		static constexpr u32 c_vertex_program_record = "VPRG"_u32;
+		static constexpr u32 c_fragment_program_record = "FPRG"_u32;
+
 		std::string version_prefix;
 		std::string root_path;
 		std::string pipeline_class_name;
-		lf_fifo<std::unique_ptr<u8[]>, 100> fragment_program_data;
+
+		// Pipelines and raw programs (deduplicated by hash)
+		std::unique_ptr<shader_cache_archive> m_archive;
 
 		backend_storage& m_storage;
 
@@ -66,7 +74,88 @@ namespace rsx
 			return fmt::format("%s pipeline object %u of %u", index == 0 ? "Loading" : "Compiling", processed, entry_count);
 		}
 
-		void load_shaders(uint nb_workers, unpacked_type& unpacked, std::string& directory_path, std::vector<fs::dir_entry>& entries, u32 entry_count,
+		std::string get_archive_path() const
+		{
+			return root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix + ".dat";
+		}
+
+		// Import pipelines stored as individual files by older versions
+		void import_legacy()
+		{
+			const std::string directory_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix;
+
+			fs::dir root(directory_path);
+
+			if (!root)
+			{
+				return;
+			}
+
+			u32 count = 0;
+
+			for (auto&& tmp : root)
+			{
+				if (tmp.is_directory)
+					continue;
+
+				pipeline_data pdata{};
+
+				if (fs::file f(directory_path + "/" + tmp.name); !f || f.size() != sizeof(pdata) || !f.read(pdata))
+				{
+					continue;
+				}
+
+				fs::file vp_file(fmt::format("%s/raw/%llX.vp", root_path, pdata.vertex_program_hash));
+				fs::file fp_file(fmt::format("%s/raw/%llX.fp", root_path, pdata.fragment_program_hash));
+
+				std::vector<u8> vp_data, fp_data;
+
+				if (!vp_file || !fp_file || !vp_file.read(vp_data, vp_file.size()) || !fp_file.read(fp_data, fp_file.size()) || vp_data.empty() || fp_data.empty())
+				{
+					continue;
+				}
+
+				m_archive->add(c_vertex_program_record, pdata.vertex_program_hash, vp_data);
+				m_archive->add(c_fragment_program_record, pdata.fragment_program_hash, fp_data);
+				m_archive->add(c_pipeline_record, rpcs3::hash_struct(pdata), {reinterpret_cast<const u8*>(&pdata), sizeof(pdata)});
+				count++;
+			}
+
+			root.close();
+
+			rsx_log.success("Shader cache: Imported %u pipeline objects from %s", count, directory_path);
+			fs::remove_all(directory_path);
+
+			// Raw programs are shared by all pipeline directories, remove them after the last one has been imported
+			bool raw_used = false;
+
+			for (auto&& class_dir : fs::dir(root_path + "/pipelines/"))
+			{
+				if (!class_dir.is_directory || class_dir.name == "." || class_dir.name == "..")
+					continue;
+
+				for (auto&& version_dir : fs::dir(root_path + "/pipelines/" + class_dir.name))
+				{
+					raw_used |= version_dir.is_directory && version_dir.name != "." && version_dir.name != "..";
+				}
+			}
+
+			if (!raw_used)
+			{
+				fs::remove_all(root_path + "/raw");
+			}
+
+			// Reopen to map imported records
+			m_archive.reset();
+			m_archive = std::make_unique<shader_cache_archive>(get_archive_path());
+
+			if (!*m_archive)
+			{
+				m_archive.reset();
+			}
+		}
+
+		void load_shaders(uint nb_workers, unpacked_type& unpacked, std::vector<shader_cache_archive::record>& entries, u32 entry_count,
 		    shader_loading_dialog* dlg)
 		{
 			atomic_t<u32> processed(0);
@@ -77,26 +166,16 @@ namespace rsx
 				// Processed is incremented before work starts in order to avoid two workers working on the same shader
 				while (((pos = processed++) < stop_at) && !Emu.IsStopped())
 				{
-					fs::dir_entry tmp = entries[pos];
-
-					const auto filename = directory_path + "/" + tmp.name;
-					fs::file f(filename);
+					const auto& rec = entries[pos];
 
-					if (!f)
+					if (rec.data.size() != sizeof(pipeline_data))
 					{
-						// Unexpected error, but avoid crash
-						continue;
-					}
-
-					if (f.size() != sizeof(pipeline_data))
-					{
-						rsx_log.error("Removing cached pipeline object %s since it's not binary compatible with the current shader cache", tmp.name.c_str());
-						fs::remove_file(filename);
+						rsx_log.error("Skipping cached pipeline object 0x%llx since it's not binary compatible with the current shader cache", rec.key);
 						continue;
 					}
 
 					pipeline_data pdata{};
-					f.read(&pdata, f.size());
+					std::memcpy(&pdata, rec.data.data(), sizeof(pdata));
 
 					auto entry = unpack(pdata);
 
@@ -207,44 +286,45 @@ namespace rsx
 					root_path = std::move(cache_path) + "shaders_cache/";
 				}
 			}
+
+			if (!root_path.empty())
+			{
+				fs::create_path(root_path + "/pipelines/" + pipeline_class_name);
+
+				m_archive = std::make_unique<shader_cache_archive>(get_archive_path());
+
+				if (!*m_archive)
+				{
+					m_archive.reset();
+				}
+			}
 		}
 
 		template <typename... Args>
 		void load(shader_loading_dialog* dlg, Args&& ...args)
 		{
-			if (root_path.empty())
+			if (!m_archive)
 			{
 				return;
 			}
 
-			std::string directory_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix;
-
-			fs::dir root = fs::dir(directory_path);
+			import_legacy();
 
-			if (!root)
+			if (!m_archive)
 			{
-				fs::create_path(directory_path);
-				fs::create_path(root_path + "/raw");
 				return;
 			}
 
-			std::vector<fs::dir_entry> entries;
+			// Programs decompiled from now on are stored along with the pipelines
+			m_storage.set_decompiled_program_archive(m_archive.get());
 
-			for (auto&& tmp : root)
-			{
-				if (tmp.is_directory)
-					continue;
-
-				entries.push_back(tmp);
-			}
+			std::vector<shader_cache_archive::record> entries = m_archive->get(c_pipeline_record);
 
 			u32 entry_count = ::size32(entries);
 
 			if (!entry_count)
 				return;
 
-			root.rewind();
-
 			// Progress dialog
 			std::unique_ptr<shader_loading_dialog> fallback_dlg;
 			if (!dlg)
@@ -263,20 +343,27 @@ namespace rsx
 			unpacked_type unpacked;
 			uint nb_workers = g_cfg.video.renderer == video_renderer::vulkan ? utils::get_thread_count() : 1;
 
-			load_shaders(nb_workers, unpacked, directory_path, entries, entry_count, dlg);
+			load_shaders(nb_workers, unpacked, entries, entry_count, dlg);
 
 			// Account for any invalid entries
 			entry_count = unpacked.size();
 
 			compile_shaders(nb_workers, unpacked, entry_count, dlg, std::forward<Args>(args)...);
 
+			const auto [decompiled_hits, decompiled_misses] = m_storage.reset_decompiled_program_stats();
+			rsx_log.notice("Shader cache: %u programs loaded without decompiling, %u programs decompiled", decompiled_hits, decompiled_misses);
+
+			// Compiled programs own copies of the data
+			entries.clear();
+			m_archive->release_image();
+
 			dlg->refresh();
 			dlg->close();
 		}
 
 		void store(const pipeline_storage_type &pipeline, const RSXVertexProgram &vp, const RSXFragmentProgram &fp)
 		{
-			if (root_path.empty())
+			if (!m_archive)
 			{
 				return;
 			}
@@ -289,67 +376,46 @@ namespace rsx
 
 			pipeline_data data = pack(pipeline, vp, fp);
 
-			std::string fp_name = root_path + "/raw/" + fmt::format("%llX.fp", data.fragment_program_hash);
-			std::string vp_name = root_path + "/raw/" + fmt::format("%llX.vp", data.vertex_program_hash);
-
-			// Writeback to cache either if file does not exist or it is invalid (unexpected size)
-			// Note: fs::write_file is not atomic, if the process is terminated in the middle an empty file is created
-			if (fs::stat_t s{}; !fs::stat(fp_name, s) || s.size != fp.ucode_length)
+			// Raw programs are shared by pipelines, only the first occurence is stored
+			if (!m_archive->contains(c_fragment_program_record, data.fragment_program_hash))
 			{
-				fs::write_file(fp_name, fs::rewrite, fp.get_data(), fp.ucode_length);
+				m_archive->add(c_fragment_program_record, data.fragment_program_hash, {static_cast<const u8*>(fp.get_data()), fp.ucode_length});
 			}
 
-			if (fs::stat_t s{}; !fs::stat(vp_name, s) || s.size != vp.data.size() * sizeof(u32))
+			if (!m_archive->contains(c_vertex_program_record, data.vertex_program_hash))
 			{
-				fs::write_file(vp_name, fs::rewrite, vp.data);
+				m_archive->add(c_vertex_program_record, data.vertex_program_hash, {reinterpret_cast<const u8*>(vp.data.data()), vp.data.size() * sizeof(u32)});
 			}
 
-			u64 state_hash = 0;
-			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_ctrl);
-			state_hash ^= rpcs3::hash_base<u32>(data.vp_texture_dimensions);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_texture_dimensions);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_texcoord_control);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_height);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_pixel_layout);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_lighting_flags);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_shadow_textures);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_redirected_textures);
-			state_hash ^= rpcs3::hash_base<u16>(data.vp_multisampled_textures);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_multisampled_textures);
-
-			const std::string pipeline_file_name = fmt::format("%llX+%llX+%llX+%llX.bin", data.vertex_program_hash, data.fragment_program_hash, data.pipeline_storage_hash, state_hash);
-			const std::string pipeline_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix + "/" + pipeline_file_name;
-			fs::write_file(pipeline_path, fs::rewrite, &data, sizeof(data));
+			m_archive->add(c_pipeline_record, rpcs3::hash_struct(data), {reinterpret_cast<const u8*>(&data), sizeof(data)});
 		}
 
 		RSXVertexProgram load_vp_raw(u64 program_hash) const
 		{
 			RSXVertexProgram vp = {};
 
-			fs::file f(fmt::format("%s/raw/%llX.vp", root_path, program_hash));
-			if (f) f.read(vp.data, f.size() / sizeof(u32));
+			if (const auto data = m_archive->find(c_vertex_program_record, program_hash); !data.empty())
+			{
+				vp.data.resize(data.size() / sizeof(u32));
+				std::memcpy(vp.data.data(), data.data(), vp.data.size() * sizeof(u32));
+			}
 
 			return vp;
 		}
 
 		RSXFragmentProgram load_fp_raw(u64 program_hash)
 		{
-			fs::file f(fmt::format("%s/raw/%llX.fp", root_path, program_hash));
-
 			RSXFragmentProgram fp = {};
 
-			const u32 size = fp.ucode_length = f ? ::size32(f) : 0;
+			// Points into the archive image which is kept until compilation is done
+			const auto data = m_archive->find(c_fragment_program_record, program_hash);
+			fp.ucode_length = ::size32(data);
 
-			if (!size)
+			if (fp.ucode_length)
 			{
-				return fp;
+				fp.data = const_cast<u8*>(data.data());
 			}
 
-			auto buf = std::make_unique<u8[]>(size);
-			fp.data = buf.get();
-			f.read(buf.get(), size);
-			fragment_program_data[fragment_program_data.push_begin()] = std::move(buf);
 			return fp;
 		}
 
@@ -26,10 +26,97 @@ extern "C"
 
 #include "util/sysinfo.hpp"
 
+#if defined(ARCH_X64)
+#include "emmintrin.h"
+#include "immintrin.h"
+#endif
+
+#ifdef ARCH_ARM64
+#ifndef _MSC_VER
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+#undef FORCE_INLINE
+#include "Emu/CPU/sse2neon.h"
+#ifndef _MSC_VER
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#if defined(_MSC_VER) || !defined(ARCH_X64)
+#define AVX2_FUNC
+#else
+#define AVX2_FUNC __attribute__((__target__("avx2")))
+#endif
+
+namespace
+{
+	// Rows of a 4x4 block of 4-byte texels are the low and high halves of (a, b) and (c, d), a-d being its 16-byte parts
+	u32 deswizzle_blocks_u32_sse2(const u32* src, u32* dst, u32 pitch, u32 count, u32 offs, u32 x_mask)
+	{
+		for (u32 i = 0; i < count; i++, dst += 4)
+		{
+			const auto block = reinterpret_cast<const __m128i*>(src + offs);
+			const __m128i a = _mm_loadu_si128(block + 0);
+			const __m128i b = _mm_loadu_si128(block + 1);
+			const __m128i c = _mm_loadu_si128(block + 2);
+			const __m128i d = _mm_loadu_si128(block + 3);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi64(a, b));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pitch), _mm_unpackhi_epi64(a, b));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pitch * 2), _mm_unpacklo_epi64(c, d));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pitch * 3), _mm_unpackhi_epi64(c, d));
+
+			offs = (offs - x_mask) & x_mask;
+		}
+
+		return offs;
+	}
+
+#if defined(ARCH_X64)
+	// Same as above, each 32-byte half of the block is permuted into two rows
+	AVX2_FUNC u32 deswizzle_blocks_u32_avx2(const u32* src, u32* dst, u32 pitch, u32 count, u32 offs, u32 x_mask)
+	{
+		const __m256i rows = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+
+		for (u32 i = 0; i < count; i++, dst += 4)
+		{
+			const auto block = reinterpret_cast<const __m256i*>(src + offs);
+			const __m256i lo = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(block + 0), rows);
+			const __m256i hi = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(block + 1), rows);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(lo));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pitch), _mm256_extracti128_si256(lo, 1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pitch * 2), _mm256_castsi256_si128(hi));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pitch * 3), _mm256_extracti128_si256(hi, 1));
+
+			offs = (offs - x_mask) & x_mask;
+		}
+
+		return offs;
+	}
+
+	const bool s_use_avx2 = utils::has_avx2();
+#endif
+}
+
 namespace rsx
 {
 	atomic_t<u64> g_rsx_shared_tag{ 0 };
 
+	u32 deswizzle_blocks_u32(const u32* src, u32* dst, u32 pitch, u32 count, u32 offs, u32 x_mask)
+	{
+#if defined(ARCH_X64)
+		if (s_use_avx2)
+		{
+			return deswizzle_blocks_u32_avx2(src, dst, pitch, count, offs, x_mask);
+		}
+#endif
+
+		return deswizzle_blocks_u32_sse2(src, dst, pitch, count, offs, x_mask);
+	}
+
 	void convert_scale_image(u8 *dst, AVPixelFormat dst_format, int dst_width, int dst_height, int dst_pitch,
 		const u8 *src, AVPixelFormat src_format, int src_width, int src_height, int src_pitch, int src_slice_h, bool bilinear)
 	{
@@ -8,6 +8,11 @@
 #include <memory>
 #include <bitset>
 #include <chrono>
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
 
 extern "C"
 {
@@ -347,14 +352,68 @@ namespace rsx
 		return offset;
 	}
 
+	// Scatter the low bits of value to the set bits of mask
+	static inline u32 deposit_bits(u32 value, u32 mask)
+	{
+#if defined(__BMI2__)
+		return _pdep_u32(value, mask);
+#else
+		u32 result = 0;
+
+		for (u32 bit = 1; mask; bit <<= 1, mask &= mask - 1)
+		{
+			if (value & bit)
+			{
+				result |= mask & (0 - mask);
+			}
+		}
+
+		return result;
+#endif
+	}
+
+	// Deswizzle count 4x4 blocks of 4-byte texels to 4 rows of pitch texels, see deswizzle_blocks (AVX2 or SSE2 kernel selected at runtime)
+	u32 deswizzle_blocks_u32(const u32* src, u32* dst, u32 pitch, u32 count, u32 offs, u32 x_mask);
+
+	// Deswizzle count 4x4 blocks of texels starting at src + offs to 4 rows of pitch texels, returns the offset of the next block
+	// Blocks are contiguous in swizzled memory, x_mask advances the offset by one block
+	template <typename T>
+	u32 deswizzle_blocks(const T* src, T* dst, u32 pitch, u32 count, u32 offs, u32 x_mask)
+	{
+		if constexpr (sizeof(T) == 4)
+		{
+			return deswizzle_blocks_u32(reinterpret_cast<const u32*>(src), reinterpret_cast<u32*>(dst), pitch, count, offs, x_mask);
+		}
+		else
+		{
+			for (u32 i = 0; i < count; i++, dst += 4)
+			{
+				const T* block = src + offs;
+
+				// Row r of the block is made of texels 0-1 and 4-5 after (r & 1) * 2 + (r & 2) * 4
+				for (u32 r = 0; r < 4; r++)
+				{
+					const u32 first = (r & 1) * 2 + (r & 2) * 4;
+					std::memcpy(dst + r * pitch, block + first, sizeof(T) * 2);
+					std::memcpy(dst + r * pitch + 2, block + first + 4, sizeof(T) * 2);
+				}
+
+				offs = (offs - x_mask) & x_mask;
+			}
+
+			return offs;
+		}
+	}
+
 	/*   Note: What the ps3 calls swizzling in this case is actually z-ordering / morton ordering of pixels
 	*       - Input can be swizzled or linear, bool flag handles conversion to and from
 	*       - It will handle any width and height that are a power of 2, square or non square
+	*       - Only rows [first_row, last_row) are converted, so large images can be split in independent bands
 	*    Restriction: It has mixed results if the height or width is not a power of 2
 	*    Restriction: Only works with 2D surfaces
 	*/
 	template <typename T, bool input_is_swizzled>
-	void convert_linear_swizzle(const void* input_pixels, void* output_pixels, u16 width, u16 height, u32 pitch)
+	void convert_linear_swizzle(const void* input_pixels, void* output_pixels, u16 width, u16 height, u32 pitch, u32 first_row = 0, u32 last_row = umax)
 	{
 		u32 log2width = ceil_log2(width);
 		u32 log2height = ceil_log2(height);
@@ -364,25 +423,29 @@ namespace rsx
 		u32 y_mask = 0xAAAAAAAA;
 
 		// We have to limit the masks to the lower of the two dimensions to allow for non-square textures
-		u32 limit_mask = (log2width < log2height) ? log2width : log2height;
+		u32 limit_log2 = (log2width < log2height) ? log2width : log2height;
 		// double the limit mask to account for bits in both x and y
-		limit_mask = 1 << (limit_mask << 1);
+		u32 limit_mask = 1 << (limit_log2 << 1);
 
 		//x_mask, bits above limit are 1's for x-carry
 		x_mask = (x_mask | ~(limit_mask - 1));
 		//y_mask. bits above limit are 0'd, as we use a different method for y-carry over
 		y_mask = (y_mask & (limit_mask - 1));
 
-		u32 offs_y = 0;
-		u32 offs_x = 0;
-		u32 offs_x0 = 0; //total y-carry offset for x
 		u32 y_incr = limit_mask;
 
+		last_row = std::min<u32>(last_row, height);
+
+		// Offsets of the first row, the y-carry happens every (1 << limit_log2) rows
+		u32 offs_y = deposit_bits(first_row, y_mask);
+		u32 offs_x = 0;
+		u32 offs_x0 = (first_row >> limit_log2) * y_incr; //total y-carry offset for x
+
 		u32 adv = pitch / sizeof(T);
 
 		if constexpr (!input_is_swizzled)
 		{
-			for (int y = 0; y < height; ++y)
+			for (u32 y = first_row; y < last_row; ++y)
 			{
 				auto src = static_cast<const T*>(input_pixels) + y * adv;
 				auto dst = static_cast<T*>(output_pixels) + offs_y;
@@ -404,19 +467,53 @@ namespace rsx
 		}
 		else
 		{
-			for (int y = 0; y < height; ++y)
+			// Groups of 4 rows are converted in 4x4 blocks if both dimensions are at least 4
+			const bool use_blocks = limit_log2 >= 2;
+			const u32 block_end = width & ~3u;
+
+			// Advances x by 4 (skips the two lowest x bits)
+			const u32 x_mask_block = x_mask & ~5u;
+
+			for (u32 y = first_row; y < last_row;)
 			{
 				auto src = static_cast<const T*>(input_pixels) + offs_y;
 				auto dst = static_cast<T*>(output_pixels) + y * adv;
-				offs_x = offs_x0;
 
-				for (int x = 0; x < width; ++x)
+				if (use_blocks && y % 4 == 0 && last_row - y >= 4)
 				{
-					dst[x] = src[offs_x];
-					offs_x = (offs_x - x_mask) & x_mask;
+					offs_x = deswizzle_blocks<T>(src, dst, adv, block_end / 4, offs_x0, x_mask_block);
+
+					// Remaining columns if the width is not a power of 2
+					for (u32 x = block_end; x < width; ++x)
+					{
+						for (u32 r = 0; r < 4; r++)
+						{
+							dst[r * adv + x] = src[offs_x + (r & 1) * 2 + (r & 2) * 4];
+						}
+
+						offs_x = (offs_x - x_mask) & x_mask;
+					}
+
+					for (u32 r = 0; r < 4; r++)
+					{
+						offs_y = (offs_y - y_mask) & y_mask;
+					}
+
+					y += 4;
 				}
+				else
+				{
+					offs_x = offs_x0;
 
-				offs_y = (offs_y - y_mask) & y_mask;
+					for (int x = 0; x < width; ++x)
+					{
+						dst[x] = src[offs_x];
+						offs_x = (offs_x - x_mask) & x_mask;
+					}
+
+					offs_y = (offs_y - y_mask) & y_mask;
+					y++;
+				}
 
 				if (offs_y == 0)
 				{
@@ -431,13 +528,14 @@ namespace rsx
 	 * Z ordering is done in all 3 planes independently with a unit being a 2x2 block per-plane
 	 * A unit in 3d textures is a group of 2x2x2 texels advancing towards depth in units of 2x2x1 blocks
 	 * i.e 32 texels per "unit"
+	 * Rows are counted across all slices (row = z * height + y), only rows [first_row, last_row) are converted
 	 */
 	template <typename T>
-	void convert_linear_swizzle_3d(const void* input_pixels, void* output_pixels, u16 width, u16 height, u16 depth)
+	void convert_linear_swizzle_3d(const void* input_pixels, void* output_pixels, u16 width, u16 height, u16 depth, u32 first_row = 0, u32 last_row = umax)
 	{
 		if (depth == 1)
 		{
-			convert_linear_swizzle<T, true>(input_pixels, output_pixels, width, height, width * sizeof(T));
+			convert_linear_swizzle<T, true>(input_pixels, output_pixels, width, height, width * sizeof(T), first_row, last_row);
 			return;
 		}
 
@@ -448,14 +546,26 @@ namespace rsx
 		const u32 log2_h = ceil_log2(height);
 		const u32 log2_d = ceil_log2(depth);
 
-		for (u32 z = 0; z < depth; ++z)
+		// Bits of each coordinate are interleaved at fixed positions, so the index is the sum of per-axis offsets
+		std::vector<u32> x_offsets(width);
+
+		for (u32 x = 0; x < width; ++x)
 		{
-			for (u32 y = 0; y < height; ++y)
+			x_offsets[x] = calculate_z_index(x, 0, 0, log2_w, log2_h, log2_d);
+		}
+
+		last_row = std::min<u32>(last_row, u32{height} * depth);
+
+		for (u32 row = first_row; row < last_row; ++row)
+		{
+			const u32 y = row % height;
+			const u32 z = row / height;
+			const T* src_row = src + (calculate_z_index(0, y, 0, log2_w, log2_h, log2_d) | calculate_z_index(0, 0, z, log2_w, log2_h, log2_d));
+			T* dst_row = dst + row * width;
+
+			for (u32 x = 0; x < width; ++x)
 			{
-				for (u32 x = 0; x < width; ++x)
-				{
-					*dst++ = src[calculate_z_index(x, y, z, log2_w, log2_h, log2_d)];
-				}
+				dst_row[x] = src_row[x_offsets[x]];
 			}
 		}
 	}
@@ -6,6 +6,7 @@
 #include "Emu/system_progress.hpp"
 #include "Emu/system_utils.hpp"
 #include "Emu/perf_meter.hpp"
+#include "Emu/perf_trace.hpp"
 #include "Emu/perf_monitor.hpp"
 #include "Emu/vfs_config.h"
 #include "Emu/IPC_config.h"
@@ -37,7 +38,7 @@
 #include "../Crypto/unself.h"
 #include "util/yaml.hpp"
 #include "util/logs.hpp"
-#include "util/serialization.hpp"
+#include "util/serialization_ext.hpp"
 
 #include <fstream>
 #include <memory>
@@ -552,7 +553,7 @@ std::string Emulator::GetBackgroundPicturePath() const
 	return path;
 }
 
-bool Emulator::BootRsxCapture(const std::string& path)
+bool Emulator::BootRsxCapture(const std::string& path, u32 bench_loops, std::function<void(std::string)> on_bench_done)
 {
 	fs::file in_file(path);
 
@@ -564,10 +565,29 @@ bool Emulator::BootRsxCapture(const std::string& path)
 	std::unique_ptr<rsx::frame_capture_data> frame = std::make_unique<rsx::frame_capture_data>();
 	utils::serial load;
 	load.set_reading_state();
-	in_file.read(load.data, in_file.size());
-	load.data.shrink_to_fit();
+
+	if (utils::compressed_serialization_file_handler::is_compressed(in_file))
+	{
+		// Chunks are decompressed on demand
+		auto handler = std::make_unique<utils::compressed_serialization_file_handler>(std::move(in_file));
+
+		if (!*handler)
+		{
+			sys_log.error("Rsx capture file is corrupted!");
+			return false;
+		}
+
+		load.m_file_handler = std::move(handler);
+	}
+	else
+	{
+		in_file.seek(0);
+		in_file.read(load.data, in_file.size());
+		load.data.shrink_to_fit();
+	}
 
 	load(*frame);
+	load.clear();
 	in_file.close();
 
 	if (frame->magic != rsx::c_fc_magic)
@@ -595,6 +615,13 @@ bool Emulator::BootRsxCapture(const std::string& path)
 	Init();
 	g_cfg.video.disable_on_disk_shader_cache.set(true);
 
+	if (bench_loops)
+	{
+		// Benchmark the frontend without a window or frame pacing
+		g_cfg.video.renderer.set(video_renderer::null);
+		g_cfg.video.frame_limit.set(frame_limit_type::none);
+	}
+
 	vm::init();
 	g_fxo->init(false);
 
@@ -604,6 +631,9 @@ bool Emulator::BootRsxCapture(const std::string& path)
 	// Initialize performance monitor
 	g_fxo->init<named_thread<perf_monitor>>();
 
+	// Initialize performance trace writer
+	g_fxo->init<named_thread<perf_trace::writer>>();
+
 	// PS3 'executable'
 	m_state = system_state::ready;
 	GetCallbacks().on_ready();
@@ -614,7 +644,7 @@ bool Emulator::BootRsxCapture(const std::string& path)
 	GetCallbacks().on_run(false);
 	m_state = system_state::starting;
 
-	ensure(g_fxo->init<named_thread<rsx::rsx_replay_thread>>("RSX Replay", std::move(frame)));
+	ensure(g_fxo->init<named_thread<rsx::rsx_replay_thread>>("RSX Replay", std::move(frame), bench_loops, std::move(on_bench_done)));
 
 	return true;
 }
@@ -660,7 +690,22 @@ game_boot_result Emulator::BootGame(const std::string& path, const std::string&
 	m_config_mode = config_mode;
 	m_config_path = config_path;
 
-	if (fs::file save{path, fs::isfile + fs::read}; save && save.size() >= 8 && save.read<u64>() == "RPCS3SAV"_u64)
+	if (fs::file save{path, fs::isfile + fs::read}; save && utils::compressed_serialization_file_handler::is_compressed(save))
+	{
+		// Compressed savestate: chunks are decompressed on demand
+		auto handler = std::make_unique<utils::compressed_serialization_file_handler>(std::move(save));
+
+		if (!*handler)
+		{
+			sys_log.error("Compressed savestate is corrupted. (path='%s')", path);
+			return game_boot_result::savestate_corrupted;
+		}
+
+		m_ar = std::make_shared<utils::serial>();
+		m_ar->set_reading_state();
+		m_ar->m_file_handler = std::move(handler);
+	}
+	else if (save && save.size() >= 8 && (save.seek(0), save.read<u64>() == "RPCS3SAV"_u64))
 	{
 		m_ar = std::make_shared<utils::serial>();
 		m_ar->set_reading_state();
@@ -822,7 +867,7 @@ game_boot_result Emulator::Load(const std::string& title_id, bool add_only, bool
 				return game_boot_result::savestate_corrupted;
 			}
 	
-			if (header.LE_format != (std::endian::native == std::endian::little) || header.offset >= m_ar->data.size())
+			if (header.LE_format != (std::endian::native == std::endian::little) || header.offset >= m_ar->get_size())
 			{
 				return game_boot_result::savestate_corrupted;
 			}
@@ -874,8 +919,18 @@ game_boot_result Emulator::Load(const std::string& title_id, bool add_only, bool
 				if (size)
 				{
 					fs::remove_all(path, false);
-					ensure(tar_object(fs::file(&m_ar->data[m_ar->pos], size)).extract(path));
-					m_ar->pos += size;
+
+					if (m_ar->m_file_handler)
+					{
+						std::vector<u8> tar_data(size);
+						m_ar->raw_serialize(tar_data.data(), size);
+						ensure(tar_object(fs::file(tar_data.data(), size)).extract(path));
+					}
+					else
+					{
+						ensure(tar_object(fs::file(&m_ar->data[m_ar->pos], size)).extract(path));
+						m_ar->pos += size;
+					}
 				}
 			};
 
@@ -1480,6 +1535,9 @@ game_boot_result Emulator::Load(const std::string& title_id, bool add_only, bool
 		// Initialize performance monitor
 		g_fxo->init<named_thread<perf_monitor>>();
 
+		// Initialize performance trace writer
+		g_fxo->init<named_thread<perf_trace::writer>>();
+
 		// Set title to actual disc title if necessary
 		const std::string disc_sfo_dir = vfs::get("/dev_bdvd/PS3_GAME/PARAM.SFO");
 
@@ -2021,6 +2079,11 @@ bool Emulator::Pause(bool freeze_emulation)
 	// Signal profilers to print results (if enabled)
 	cpu_thread::flush_profilers();
 
+	if (g_cfg.core.perf_trace)
+	{
+		perf_trace::dump_async();
+	}
+
 	GetCallbacks().on_pause();
 
 	static atomic_t<u32> pause_mark = 0;
@@ -2351,10 +2414,22 @@ std::shared_ptr<utils::serial> Emulator::Kill(bool allow_autoexit, bool savestat
 
 	sys_log.notice("All threads have been stopped.");
 
+	std::string savestate_path;
+	std::unique_ptr<fs::pending_file> savestate_file;
+
 	if (savestate)
 	{
+		savestate_path = fs::get_cache_dir() + "/savestates/" + (m_title_id.empty() ? m_path.substr(m_path.find_last_of(fs::delim) + 1) : m_title_id) + ".SAVESTAT";
+		savestate_file = std::make_unique<fs::pending_file>(savestate_path);
+
 		to_ar = std::make_unique<utils::serial>();
 
+		if (g_cfg.savestate.compress && savestate_file->file)
+		{
+			// Stream compressed data to the file while capturing
+			to_ar->m_file_handler = std::make_unique<utils::compressed_serialization_file_handler>(savestate_file->file);
+		}
+
 		// Savestate thread
 		named_thread emu_state_cap_thread("Emu State Capture Thread", [&]()
 		{
@@ -2368,16 +2443,19 @@ std::shared_ptr<utils::serial> Emulator::Kill(bool allow_autoexit, bool savestat
 			read_used_savestate_versions(); // Reset version data
 			USING_SERIALIZATION_VERSION(global_version);
 
-			// Avoid duplicating TAR object memory because it can be very large
+			// Stream TAR object into the archive because it can be very large
 			auto save_tar = [&](const std::string& path)
 			{
-				ar(usz{}); // Reserve memory to be patched later with correct size
-				const usz old_size = ar.data.size();
-				ar.data = tar_object::save_directory(path, std::move(ar.data));
-				ar.seek_end();
-				const usz tar_size = ar.data.size() - old_size;
-				std::memcpy(ar.data.data() + old_size - sizeof(usz), &tar_size, sizeof(usz));
-				sys_log.success("Saved the contents of directory '%s' (size=0x%x)", path, tar_size);
+				const usz old_size = ar.get_size();
+
+				if (!tar_object::save_directory(path, ar))
+				{
+					sys_log.error("Failed to save the contents of directory '%s'", path);
+					ar.m_failed = true;
+					return;
+				}
+
+				sys_log.success("Saved the contents of directory '%s' (size=0x%x)", path, ar.get_size() - old_size - sizeof(usz));
 			};
 
 			auto save_hdd1 = [&]()
@@ -2450,6 +2528,7 @@ std::shared_ptr<utils::serial> Emulator::Kill(bool allow_autoexit, bool savestat
 			save_hdd0();
 			ar(std::array<u8, 32>{}); // Reserved for future use
 			vm::save(ar);
+			ar.breathe();
 			g_fxo->save(ar);
 			ar(std::array<u8, 32>{}); // Reserved for future use
 			ar(timestamp);
@@ -2462,6 +2541,7 @@ std::shared_ptr<utils::serial> Emulator::Kill(bool allow_autoexit, bool savestat
 		{
 			sys_log.error("Saving savestate failed due to fatal error!");
 			to_ar.reset();
+			savestate_file.reset();
 			savestate = false;
 		}
 	}
@@ -2482,6 +2562,13 @@ std::shared_ptr<utils::serial> Emulator::Kill(bool allow_autoexit, bool savestat
 
 	perf_stat_base::report();
 
+	if (g_cfg.core.perf_trace)
+	{
+		perf_trace::dump();
+	}
+
+	perf_trace::reset();
+
 	static u64 aw_refs = 0;
 	static u64 aw_colm = 0;
 	static u64 aw_colc = 0;
@@ -2510,27 +2597,30 @@ std::shared_ptr<utils::serial> Emulator::Kill(bool allow_autoexit, bool savestat
 
 	if (savestate)
 	{
-		const std::string path = fs::get_cache_dir() + "/savestates/" + (m_title_id.empty() ? m_path.substr(m_path.find_last_of(fs::delim) + 1) : m_title_id) + ".SAVESTAT";
-
-		fs::pending_file file(path);
+		const std::string& path = savestate_path;
+		fs::pending_file& file = *savestate_file;
 
 		// Identifer -> version
 		std::vector<std::pair<u16, u16>> used_serial = read_used_savestate_versions();
 
 		auto& ar = *to_ar;
 		const usz pos = ar.seek_end();
-		std::memcpy(&ar.data[10], &pos, 8);// Set offset
+		ar.patch_raw_data(10, &pos, 8); // Set offset
 		ar(used_serial);
 
-		if (!file.file || (file.file.write(ar.data), !file.commit()))
+		const bool written = !ar.m_failed && (ar.m_file_handler ? ar.m_file_handler->finalize(ar) : file.file && file.file.write(ar.data) == ar.data.size());
+
+		if (!file.file || !written || !file.commit())
 		{
 			sys_log.error("Failed to write savestate to file! (path='%s', %s)", path, fs::g_tls_error);
 		}
 		else
 		{
-			sys_log.success("Saved savestate! path='%s'", path);
+			sys_log.success("Saved savestate! path='%s' (size=0x%x)", path, ar.get_size());
 		}
 
+		ar.m_file_handler.reset();
+
 		ar.set_reading_state();
 	}
 
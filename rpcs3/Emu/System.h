@@ -291,7 +291,8 @@ public:
 	}
 
 	game_boot_result BootGame(const std::string& path, const std::string& title_id = "", bool direct = false, bool add_only = false, cfg_mode config_mode = cfg_mode::custom, const std::string& config_path = "");
-	bool BootRsxCapture(const std::string& path);
+	// Boot RSX capture replay, loops > 0 replays the capture that many times and reports timings (benchmark mode)
+	bool BootRsxCapture(const std::string& path, u32 bench_loops = 0, std::function<void(std::string)> on_bench_done = nullptr);
 
 	void SetForceBoot(bool force_boot);
 
@@ -23,29 +23,146 @@ namespace rpcs3::cache
 		return _main.cache;
 	}
 
-	void limit_cache_size()
+	std::string get_object_store()
 	{
-		const std::string cache_location = rpcs3::utils::get_hdd1_dir() + "/caches";
+		return fs::get_cache_dir() + "cache/objects/";
+	}
+
+	bool get_shared_object(const std::string& dir, const std::string& name)
+	{
+		const std::string from = get_object_store() + name;
+		const std::string to = dir + name;
+
+		if (!fs::is_file(from))
+		{
+			return false;
+		}
+
+		// Mark as recently used for limit_cache_size
+		const s64 now = std::time(nullptr);
+		fs::utime(from, now, now);
 
-		if (!fs::is_dir(cache_location))
+		if (fs::create_hard_link(from, to) || fs::g_tls_error == fs::error::exist)
 		{
-			sys_log.warning("Cache does not exist (%s)", cache_location);
+			return true;
+		}
+
+		// Fallback for filesystems without hard link support
+		if (!fs::copy_file(from, to, false) && fs::g_tls_error != fs::error::exist)
+		{
+			sys_log.error("Failed to copy shared object '%s' (%s)", name, fs::g_tls_error);
+			fs::remove_file(to);
+			return false;
+		}
+
+		return true;
+	}
+
+	void add_shared_object(const std::string& dir, const std::string& name)
+	{
+		const std::string store = get_object_store();
+		const std::string from = dir + name;
+		const std::string to = store + name;
+
+		if (!fs::create_path(store))
+		{
+			sys_log.error("Failed to create object store '%s' (%s)", store, fs::g_tls_error);
 			return;
 		}
 
-		const u64 size = fs::get_dir_size(cache_location);
+		// Replace existing object (it's only compiled again if the stored one was damaged)
+		if (fs::is_file(to) && !fs::remove_file(to))
+		{
+			sys_log.error("Failed to replace shared object '%s' (%s)", name, fs::g_tls_error);
+			return;
+		}
 
-		if (size == umax)
+		if (fs::create_hard_link(from, to) || fs::g_tls_error == fs::error::exist)
 		{
-			sys_log.error("Could not calculate cache directory '%s' size (%s)", cache_location, fs::g_tls_error);
 			return;
 		}
 
+		if (!fs::copy_file(from, to, false))
+		{
+			sys_log.error("Failed to add shared object '%s' (%s)", name, fs::g_tls_error);
+			fs::remove_file(to);
+		}
+	}
+
+	std::string get_self_cache()
+	{
+		return fs::get_cache_dir() + "cache/self/";
+	}
+
+	// Objects of the store which are also linked into a title cache take no space of their own
+	static bool is_linked_object(const std::string& path)
+	{
+		return path.starts_with(get_object_store()) && fs::get_link_count(path) > 1;
+	}
+
+	void limit_cache_size()
+	{
+		// The shared object store and decrypted SELF images are limited together with the game cache
+		const std::string locations[] = { rpcs3::utils::get_hdd1_dir() + "/caches", get_object_store(), get_self_cache() };
+
+		// Size of a location, shared objects which are still in use are not counted
+		const auto get_location_size = [](const std::string& location) -> u64
+		{
+			if (location != get_object_store())
+			{
+				return fs::get_dir_size(location);
+			}
+
+			fs::dir store(location);
+
+			if (!store)
+			{
+				return umax;
+			}
+
+			u64 result = 0;
+
+			for (const auto& entry : store)
+			{
+				if (!entry.is_directory && !is_linked_object(location + entry.name))
+				{
+					result += entry.size;
+				}
+			}
+
+			return result;
+		};
+
+		u64 size = 0;
+
+		for (const std::string& location : locations)
+		{
+			// Missing locations are normal (e.g. no decrypted SELF images)
+			if (!fs::is_dir(location))
+			{
+				continue;
+			}
+
+			const u64 location_size = get_location_size(location);
+
+			if (location_size == umax)
+			{
+				sys_log.error("Could not calculate cache directory '%s' size (%s)", location, fs::g_tls_error);
+				return;
+			}
+
+			size += location_size;
+		}
+
 		const u64 max_size = static_cast<u64>(g_cfg.vfs.cache_max_size) * 1024 * 1024;
 
 		if (max_size == 0) // Everything must go, so no need to do checks
 		{
-			fs::remove_all(cache_location, false);
+			for (const std::string& location : locations)
+			{
+				fs::remove_all(location, false);
+			}
+
 			sys_log.success("Cleared disk cache");
 			return;
 		}
@@ -57,45 +174,51 @@ namespace rpcs3::cache
 		}
 
 		sys_log.success("Cleaning disk cache...");
-		std::vector<fs::dir_entry> file_list{};
-		fs::dir cache_dir(cache_location);
-		if (!cache_dir)
-		{
-			sys_log.error("Could not open cache directory '%s' (%s)", cache_location, fs::g_tls_error);
-			return;
-		}
+		std::vector<std::pair<std::string, fs::dir_entry>> file_list{};
 
-		// retrieve items to delete
-		for (const auto &item : cache_dir)
+		for (const std::string& location : locations)
 		{
-			if (item.name != "." && item.name != "..")
-				file_list.push_back(item);
-		}
+			if (!fs::is_dir(location))
+			{
+				continue;
+			}
 
-		cache_dir.close();
+			fs::dir cache_dir(location);
+			if (!cache_dir)
+			{
+				sys_log.error("Could not open cache directory '%s' (%s)", location, fs::g_tls_error);
+				return;
+			}
+
+			// retrieve items to delete (removing shared objects in use would free nothing)
+			for (const auto &item : cache_dir)
+			{
+				if (item.name != "." && item.name != ".." && !is_linked_object(location + item.name))
+					file_list.emplace_back(location + "/" + item.name, item);
+			}
+		}
 
 		// sort oldest first
-		std::sort(file_list.begin(), file_list.end(), FN(x.mtime < y.mtime));
+		std::sort(file_list.begin(), file_list.end(), FN(x.second.mtime < y.second.mtime));
 
 		// keep removing until cache is empty or enough bytes have been cleared
 		// cache is cleared down to 80% of limit to increase interval between clears
 		const u64 to_remove = static_cast<u64>(size - max_size * 0.8);
 		u64 removed = 0;
-		for (const auto &item : file_list)
+		for (const auto& [name, item] : file_list)
 		{
-			const std::string &name = cache_location + "/" + item.name;
 			const bool is_dir = fs::is_dir(name);
 			const u64 item_size = is_dir ? fs::get_dir_size(name) : item.size;
 
 			if (is_dir && item_size == umax)
 			{
-				sys_log.error("Failed to calculate '%s' item '%s' size (%s)", cache_location, item.name, fs::g_tls_error);
+				sys_log.error("Failed to calculate cache item '%s' size (%s)", name, fs::g_tls_error);
 				break;
 			}
 
 			if (is_dir ? !fs::remove_all(name, true, true) : !fs::remove_file(name))
 			{
-				sys_log.error("Could not remove cache directory '%s' item '%s' (%s)", cache_location, item.name, fs::g_tls_error);
+				sys_log.error("Could not remove cache item '%s' (%s)", name, fs::g_tls_error);
 				break;
 			}
 
@@ -104,6 +227,6 @@ namespace rpcs3::cache
 				break;
 		}
 
-		sys_log.success("Cleaned disk cache, removed %.2f MB", size / 1024.0 / 1024.0);
+		sys_log.success("Cleaned disk cache, removed %.2f MB", removed / 1024.0 / 1024.0);
 	}
 }
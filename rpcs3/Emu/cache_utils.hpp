@@ -3,5 +3,18 @@
 namespace rpcs3::cache
 {
 	std::string get_ppu_cache();
+
+	// Location of compiled objects shared between titles (named by content hash)
+	std::string get_object_store();
+
+	// Make the shared object available in dir (hard link or copy), returns false if not stored
+	bool get_shared_object(const std::string& dir, const std::string& name);
+
+	// Add the object from dir to the shared store
+	void add_shared_object(const std::string& dir, const std::string& name);
+
+	// Location of decrypted SELF images (named by content hash)
+	std::string get_self_cache();
+
 	void limit_cache_size();
 }
@@ -0,0 +1,11 @@
+#include "stdafx.h"
+
+#include <iostream>
+
+// Default fatal error handler for programs linking rpcs3_emu without the main executable (benchmarks)
+// The executable defines its own handler (main.cpp), this object is not linked from the static library then
+[[noreturn]] void report_fatal_error(std::string_view text)
+{
+	std::cerr << fmt::format("RPCS3: %s\n", text);
+	std::abort();
+}
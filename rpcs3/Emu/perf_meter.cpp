@@ -154,3 +154,41 @@ void perf_stat_base::report() noexcept
 
 	perf_log.notice("Performance report end.");
 }
+
+std::vector<std::pair<std::string, perf_stat_base::values_t>> perf_stat_base::snapshot() noexcept
+{
+	std::lock_guard lock(s_perf_mutex);
+
+	std::map<std::string_view, values_t> values;
+
+	for (auto& [name, data] : s_perf_acc)
+	{
+		auto& dst = values[name];
+
+		for (u32 i = 0; i < 66; i++)
+		{
+			dst[i] = data.m_log[i].load();
+		}
+	}
+
+	// Only read the TLS data of running threads, it's updated without atomic operations by its owner
+	for (auto& [name, ns] : s_perf_sources)
+	{
+		auto& dst = values[name];
+
+		for (u32 i = 0; i < 66; i++)
+		{
+			dst[i] += atomic_storage<u64>::load(ns[i]);
+		}
+	}
+
+	std::vector<std::pair<std::string, values_t>> result;
+	result.reserve(values.size());
+
+	for (auto& [name, data] : values)
+	{
+		result.emplace_back(name, data);
+	}
+
+	return result;
+}
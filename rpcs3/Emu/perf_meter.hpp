@@ -6,6 +6,8 @@
 #include "system_config.h"
 #include <array>
 #include <cmath>
+#include <string>
+#include <vector>
 
 LOG_CHANNEL(perf_log, "PERF");
 
@@ -50,6 +52,12 @@ public:
 
 	// Collect all data, report it, and clean
 	static void report() noexcept;
+
+	// Accumulated values: [0] event count, [1..64] log2 histogram of event lengths in ns, [65] total ns
+	using values_t = std::array<u64, 66>;
+
+	// Read data of all threads without stopping or draining them, get values accumulated since the last report
+	static std::vector<std::pair<std::string, values_t>> snapshot() noexcept;
 };
 
 // Object that prints event length stats at the end
@@ -1,15 +1,101 @@
 #include "stdafx.h"
 #include "perf_monitor.hpp"
+#include "perf_meter.hpp"
 #include "util/cpu_stats.hpp"
+#include "Utilities/File.h"
 #include "Utilities/Thread.h"
 
+#include <chrono>
+#include <unordered_map>
+
 LOG_CHANNEL(sys_log, "SYS");
 
+namespace
+{
+	// Writes performance report deltas as JSON lines, one line per snapshot
+	// hist[i] is the number of events which took [2^i, 2^(i+1)) ns
+	class perf_telemetry_writer
+	{
+		// Rotate the file when it gets too big for long sessions
+		static constexpr u64 max_file_size = 64 * 1024 * 1024;
+
+		const std::string m_path = fs::get_cache_dir() + "perf_telemetry.jsonl";
+		const std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+
+		fs::file m_file;
+		std::unordered_map<std::string, perf_stat_base::values_t> m_last;
+
+	public:
+		void write()
+		{
+			if (!m_file || m_file.size() >= max_file_size)
+			{
+				if (m_file)
+				{
+					m_file.close();
+					fs::rename(m_path, m_path + ".old", true);
+				}
+
+				if (!m_file.open(m_path, fs::rewrite))
+				{
+					sys_log.error("Failed to open %s (%s)", m_path, fs::g_tls_error);
+					return;
+				}
+			}
+
+			const auto time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start).count();
+
+			std::string line = fmt::format("{\"time_ms\":%u,\"stats\":{", time_ms);
+			bool first = true;
+
+			for (const auto& [name, values] : perf_stat_base::snapshot())
+			{
+				auto& last = m_last[name];
+
+				// Accumulated values are cleared by the performance report
+				if (values[0] < last[0] || values[65] < last[65])
+				{
+					last = {};
+				}
+
+				if (values[0] == last[0])
+				{
+					continue;
+				}
+
+				u32 hist_size = 64;
+
+				while (hist_size && values[hist_size] == last[hist_size])
+				{
+					hist_size--;
+				}
+
+				fmt::append(line, "%s\"%s\":{\"events\":%u,\"total_ns\":%u,\"hist\":[", first ? "" : ",", name, values[0] - last[0], values[65] - last[65]);
+
+				for (u32 i = 1; i <= hist_size; i++)
+				{
+					fmt::append(line, "%s%u", i == 1 ? "" : ",", values[i] - last[i]);
+				}
+
+				line += "]}";
+				first = false;
+				last = values;
+			}
+
+			line += "}}\n";
+			m_file.write(line);
+		}
+	};
+}
+
 void perf_monitor::operator()()
 {
 	constexpr u64 update_interval_us = 1000000; // Update every second
 	constexpr u64 log_interval_us = 10000000;   // Log every 10 seconds
 	u64 elapsed_us = 0;
+	u64 telemetry_elapsed_us = 0;
+
+	perf_telemetry_writer telemetry;
 
 	utils::cpu_stats stats;
 	stats.init_cpu_query();
@@ -42,6 +128,17 @@ void perf_monitor::operator()()
 
 			sys_log.notice("%s", msg);
 		}
+
+		if (const u64 telemetry_interval_us = g_cfg.core.perf_telemetry_interval * 1000000; telemetry_interval_us && g_cfg.core.perf_report)
+		{
+			telemetry_elapsed_us += update_interval_us;
+
+			if (telemetry_elapsed_us >= telemetry_interval_us)
+			{
+				telemetry_elapsed_us = 0;
+				telemetry.write();
+			}
+		}
 	}
 }
 
@@ -0,0 +1,282 @@
+#include "stdafx.h"
+#include "perf_trace.hpp"
+#include "system_config.h"
+#include "IdManager.h"
+
+#include "Utilities/File.h"
+#include "Utilities/Thread.h"
+#include "util/sysinfo.hpp"
+#include "util/tsc.hpp"
+
+#include <memory>
+#include <mutex>
+
+LOG_CHANNEL(perf_log, "PERF");
+
+namespace perf_trace
+{
+	struct trace_event
+	{
+		u64 tsc;
+		const char* name;
+		u64 arg;
+		event_type type;
+	};
+
+	// Written by the owner thread only
+	struct thread_ring
+	{
+		static constexpr u64 c_size = 0x4000;
+
+		std::unique_ptr<trace_event[]> events = std::make_unique<trace_event[]>(c_size);
+
+		// Number of events recorded
+		atomic_t<u64> pos = 0;
+
+		// Events before this position were dropped by reset()
+		atomic_t<u64> floor = 0;
+	};
+
+	struct thread_entry
+	{
+		std::string name;
+
+		// Ring of the running thread
+		std::shared_ptr<thread_ring> ring;
+
+		// Events left after the thread has exited
+		std::vector<trace_event> retired;
+	};
+
+	static shared_mutex s_mutex;
+
+	static std::vector<thread_entry> s_threads;
+
+	atomic_t<bool> g_enabled = false;
+
+	// Copy valid events of a ring (may be written concurrently)
+	static std::vector<trace_event> copy_events(const thread_ring& ring)
+	{
+		const u64 end = ring.pos.load();
+		const u64 begin = std::max<u64>(end > thread_ring::c_size ? end - thread_ring::c_size : 0, ring.floor.load());
+
+		std::vector<trace_event> result;
+		result.reserve(end > begin ? end - begin : 0);
+
+		for (u64 i = begin; i < end; i++)
+		{
+			result.push_back(ring.events[i % thread_ring::c_size]);
+		}
+
+		// Drop events which could have been overwritten during the copy (including the unpublished one)
+		const u64 new_end = ring.pos.load();
+
+		if (const u64 lost = new_end >= thread_ring::c_size + begin ? new_end - thread_ring::c_size - begin + 1 : 0)
+		{
+			result.erase(result.begin(), result.begin() + std::min<u64>(lost, result.size()));
+		}
+
+		return result;
+	}
+
+	static thread_local struct thread_ring_holder
+	{
+		std::shared_ptr<thread_ring> ring;
+
+		thread_ring& get() noexcept
+		{
+			if (!ring) [[unlikely]]
+			{
+				ring = std::make_shared<thread_ring>();
+
+				std::lock_guard lock(s_mutex);
+
+				s_threads.emplace_back(thread_entry{thread_ctrl::get_current() ? thread_ctrl::get_name() : std::string("Unknown"), ring, {}});
+			}
+
+			return *ring;
+		}
+
+		~thread_ring_holder()
+		{
+			if (!ring)
+			{
+				return;
+			}
+
+			std::lock_guard lock(s_mutex);
+
+			// Keep events of exited threads without keeping their ring (entries are moved by reset())
+			const auto found = std::find_if(s_threads.begin(), s_threads.end(), [&](const thread_entry& entry)
+			{
+				return entry.ring == ring;
+			});
+
+			if (found != s_threads.end())
+			{
+				found->retired = copy_events(*ring);
+				found->ring.reset();
+			}
+		}
+	} s_tls_ring;
+
+	void record(event_type type, const char* name, u64 arg) noexcept
+	{
+		auto& ring = s_tls_ring.get();
+
+		const u64 pos = ring.pos.raw();
+		ring.events[pos % thread_ring::c_size] = trace_event{utils::get_tsc(), name, arg, type};
+		ring.pos.release(pos + 1);
+	}
+
+	void reset() noexcept
+	{
+		std::lock_guard lock(s_mutex);
+
+		// Forget exited threads
+		std::erase_if(s_threads, [](const thread_entry& entry)
+		{
+			return !entry.ring;
+		});
+
+		for (auto& entry : s_threads)
+		{
+			entry.ring->floor.release(entry.ring->pos.load());
+		}
+	}
+
+	static void append_escaped(std::string& out, std::string_view str)
+	{
+		for (const char c : str)
+		{
+			if (c == '"' || c == '\\')
+			{
+				out += '\\';
+				out += c;
+			}
+			else if (static_cast<u8>(c) < 0x20)
+			{
+				fmt::append(out, "\\u%04x", static_cast<u8>(c));
+			}
+			else
+			{
+				out += c;
+			}
+		}
+	}
+
+	bool dump()
+	{
+		std::vector<std::pair<std::string, std::vector<trace_event>>> threads;
+		{
+			std::lock_guard lock(s_mutex);
+
+			for (const auto& entry : s_threads)
+			{
+				threads.emplace_back(entry.name, entry.ring ? copy_events(*entry.ring) : entry.retired);
+			}
+		}
+
+		u64 base_tsc = umax;
+		usz count = 0;
+
+		for (const auto& [name, events] : threads)
+		{
+			for (const auto& event : events)
+			{
+				base_tsc = std::min(base_tsc, event.tsc);
+			}
+
+			count += events.size();
+		}
+
+		const f64 tsc_to_us = 1000'000. / std::max<u64>(utils::get_tsc_freq(), 1);
+
+		std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+		out.reserve(count * 80);
+
+		for (usz tid = 0; tid < threads.size(); tid++)
+		{
+			const auto& [name, events] = threads[tid];
+
+			if (events.empty())
+			{
+				continue;
+			}
+
+			fmt::append(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"", tid);
+			append_escaped(out, name);
+			out += "\"}}";
+
+			for (const auto& event : events)
+			{
+				const f64 ts = (event.tsc - base_tsc) * tsc_to_us;
+
+				switch (event.type)
+				{
+				case event_type::begin:
+				case event_type::instant:
+				{
+					out += ",\n{\"name\":\"";
+					append_escaped(out, event.name);
+					fmt::append(out, "\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":0,\"tid\":%u,\"args\":{\"arg\":\"0x%x\"}}",
+						event.type == event_type::begin ? "B" : "i\",\"s\":\"t", ts, tid, event.arg);
+					break;
+				}
+				case event_type::end:
+				{
+					fmt::append(out, ",\n{\"ph\":\"E\",\"ts\":%.3f,\"pid\":0,\"tid\":%u}", ts, tid);
+					break;
+				}
+				}
+			}
+
+			out += ",\n";
+		}
+
+		if (out.ends_with(",\n"))
+		{
+			out.resize(out.size() - 2);
+		}
+
+		out += "\n]}\n";
+
+		const std::string path = fs::get_cache_dir() + "perf_trace.json";
+
+		if (!fs::write_file(path, fs::rewrite, out))
+		{
+			perf_log.error("Failed to write trace to %s (%s)", path, fs::g_tls_error);
+			return false;
+		}
+
+		perf_log.notice("Trace written to %s (%u events, %u threads)", path, count, threads.size());
+		return true;
+	}
+
+	void dump_async()
+	{
+		if (auto thread = g_fxo->try_get<named_thread<writer>>())
+		{
+			thread->requests++;
+			thread->requests.notify_one();
+		}
+	}
+
+	void writer::operator()()
+	{
+		while (thread_ctrl::state() != thread_state::aborting)
+		{
+			// The setting can be changed while running
+			g_enabled = g_cfg.core.perf_trace.get();
+
+			if (!requests)
+			{
+				thread_ctrl::wait_on(requests, 0, 1'000'000);
+				continue;
+			}
+
+			requests.release(0);
+			dump();
+		}
+	}
+}
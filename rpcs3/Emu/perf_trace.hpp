@@ -0,0 +1,95 @@
+#pragma once
+
+#include "util/types.hpp"
+#include "util/atomic.hpp"
+
+// Timeline of emulator thread activity, written as Chrome trace JSON (chrome://tracing, Perfetto)
+// Every thread records into its own ring buffer, only the latest events of each thread are kept
+namespace perf_trace
+{
+	// Copy of the setting (Core: Enable Performance Trace), updated by the writer thread
+	extern atomic_t<bool> g_enabled;
+
+	enum class event_type : u8
+	{
+		begin,
+		end,
+		instant,
+	};
+
+	// Record event of the current thread (name must be a string literal)
+	void record(event_type type, const char* name, u64 arg) noexcept;
+
+	// Begin a duration event on the current thread
+	inline void begin(const char* name, u64 arg = 0) noexcept
+	{
+		if (g_enabled) [[unlikely]]
+		{
+			record(event_type::begin, name, arg);
+		}
+	}
+
+	// End the last duration event of the current thread
+	inline void end() noexcept
+	{
+		if (g_enabled) [[unlikely]]
+		{
+			record(event_type::end, nullptr, 0);
+		}
+	}
+
+	inline void instant(const char* name, u64 arg = 0) noexcept
+	{
+		if (g_enabled) [[unlikely]]
+		{
+			record(event_type::instant, name, arg);
+		}
+	}
+
+	// Duration event for the lifetime of the object
+	class scope
+	{
+		const bool m_active;
+
+	public:
+		explicit scope(const char* name, u64 arg = 0) noexcept
+			: m_active(g_enabled)
+		{
+			if (m_active) [[unlikely]]
+			{
+				record(event_type::begin, name, arg);
+			}
+		}
+
+		scope(const scope&) = delete;
+
+		scope& operator=(const scope&) = delete;
+
+		~scope()
+		{
+			if (m_active) [[unlikely]]
+			{
+				record(event_type::end, nullptr, 0);
+			}
+		}
+	};
+
+	// Drop recorded events
+	void reset() noexcept;
+
+	// Write recorded events of all threads to perf_trace.json in the cache directory
+	bool dump();
+
+	// Request a dump from the writer thread (requests made while it's busy are merged)
+	void dump_async();
+
+	// Writes the trace on request (e.g. on pause), owned by g_fxo and joined on stop
+	struct writer
+	{
+		atomic_t<u32> requests = 0;
+
+		void operator()();
+
+		static constexpr auto thread_name = "Trace Writer"sv;
+	};
+}
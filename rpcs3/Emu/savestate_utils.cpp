@@ -1,6 +1,6 @@
 #include "stdafx.h"
 #include "util/types.hpp"
-#include "util/serialization.hpp"
+#include "util/serialization_ext.hpp"
 #include "util/logs.hpp"
 #include "Utilities/File.h"
 #include "system_config.h"
@@ -81,6 +81,36 @@ std::vector<std::pair<u16, u16>> get_savestate_versioning_data(const fs::file& f
 		return {};
 	}
 
+	if (utils::compressed_serialization_file_handler::is_compressed(file))
+	{
+		auto handler = std::make_unique<utils::compressed_serialization_file_handler>(file, false);
+
+		if (!*handler)
+		{
+			return {};
+		}
+
+		utils::serial ar;
+		ar.set_reading_state();
+		ar.m_file_handler = std::move(handler);
+
+		if (ar.get_size() < 18)
+		{
+			return {};
+		}
+
+		ar.pos = 10;
+		const usz offs = ar;
+
+		if (!offs || ar.get_size() <= offs)
+		{
+			return {};
+		}
+
+		ar.pos = offs;
+		return ar;
+	}
+
 	file.seek(0);
 
 	if (u64 r = 0; !file.read(r) || r != "RPCS3SAV"_u64)
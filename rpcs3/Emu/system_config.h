@@ -60,6 +60,7 @@ struct cfg_root : cfg::node
 		fifo_setting rsx_fifo_accuracy{this, "RSX FIFO Accuracy", rsx_fifo_mode::fast };
 		cfg::_bool spu_verification{ this, "SPU Verification", true }; // Should be enabled
 		cfg::_bool spu_cache{ this, "SPU Cache", true };
+		cfg::_bool self_cache{ this, "SELF Decryption Cache", false };
 		cfg::_bool spu_prof{ this, "SPU Profiler", false };
 		cfg::uint<0, 16> mfc_transfers_shuffling{ this, "MFC Commands Shuffling Limit", 0 };
 		cfg::uint<0, 10000> mfc_transfers_timeout{ this, "MFC Commands Timeout", 0, true };
@@ -85,6 +86,7 @@ struct cfg_root : cfg::node
 		cfg::_bool hle_lwmutex{ this, "HLE lwmutex" }; // Force alternative lwmutex/lwcond implementation
 		cfg::uint64 spu_llvm_lower_bound{ this, "SPU LLVM Lower Bound" };
 		cfg::uint64 spu_llvm_upper_bound{ this, "SPU LLVM Upper Bound", 0xffffffffffffffff };
+		cfg::uint<0, 1000000> spu_llvm_tiering_threshold{ this, "SPU LLVM Tiering Threshold", 0, true }; // Execution weight required to compile a program with LLVM (0 - compile everything)
 		cfg::uint64 tx_limit1_ns{this, "TSX Transaction First Limit", 800}; // In nanoseconds
 		cfg::uint64 tx_limit2_ns{this, "TSX Transaction Second Limit", 2000}; // In nanoseconds
 
@@ -99,6 +101,8 @@ struct cfg_root : cfg::node
 
 		cfg::uint64 perf_report_threshold{this, "Performance Report Threshold", 500, true}; // In µs, 0.5ms = default, 0 = everything
 		cfg::_bool perf_report{this, "Enable Performance Report", false, true}; // Show certain perf-related logs
+		cfg::uint<0, 3600> perf_telemetry_interval{this, "Performance Telemetry Interval", 0, true}; // In seconds, 0 = disabled; write performance report deltas to perf_telemetry.jsonl while running
+		cfg::_bool perf_trace{this, "Enable Performance Trace", false, true}; // Record thread timeline, written to perf_trace.json on pause and stop
 		cfg::_bool external_debugger{this, "Assume External Debugger"};
 	} core{ this };
 
@@ -147,7 +151,9 @@ struct cfg_root : cfg::node
 		cfg::_bool disable_zcull_queries{ this, "Disable ZCull Occlusion Queries", false, true };
 		cfg::_bool disable_video_output{ this, "Disable Video Output", false, true };
 		cfg::_bool disable_vertex_cache{ this, "Disable Vertex Cache", false };
+		cfg::_bool disable_index_cache{ this, "Disable Index Buffer Cache", false };
 		cfg::_bool disable_FIFO_reordering{ this, "Disable FIFO Reordering", false };
+		cfg::uint<1, 1000> capture_frame_count{ this, "RSX Capture Frame Count", 1, true }; // Number of frames recorded by RSX captures
 		cfg::_bool frame_skip_enabled{ this, "Enable Frame Skip", false, true };
 		cfg::_bool force_cpu_blit_processing{ this, "Force CPU Blit", false, true }; // Debugging option
 		cfg::_bool disable_on_disk_shader_cache{ this, "Disable On-Disk Shader Cache", false };
@@ -171,6 +177,7 @@ struct cfg_root : cfg::node
 		cfg::_int<-16, 16> texture_lod_bias{ this, "Texture LOD Bias Addend", 0, true };
 		cfg::_int<1, 1024> min_scalable_dimension{ this, "Minimum Scalable Dimension", 16 };
 		cfg::_int<0, 16> shader_compiler_threads_count{ this, "Shader Compiler Threads", 0 };
+		cfg::_int<0, 16> texture_decoding_threads_count{ this, "Texture Decoding Threads", 0 };
 		cfg::_int<0, 30000000> driver_recovery_timeout{ this, "Driver Recovery Timeout", 1000000, true };
 		cfg::uint<0, 16667> driver_wakeup_delay{ this, "Driver Wake-Up Delay", 1, true };
 		cfg::_int<1, 1800> vblank_rate{ this, "Vblank Rate", 60, true }; // Changing this from 60 may affect game speed in unexpected ways
@@ -318,6 +325,7 @@ struct cfg_root : cfg::node
 		cfg::_bool suspend_emu{ this, "Suspend Emulation Savestate Mode", true }; // Close emulation when saving, delete save after loading
 		cfg::_bool state_inspection_mode{ this, "Inspection Mode Savestates" }; // Save memory stored in executable files, thus allowing to view state without any files (for debugging)
 		cfg::_bool save_disc_game_data{ this, "Save Disc Game Data", false };
+		cfg::_bool compress{ this, "Compress Savestates", true }; // Stream compressed chunks to the file while saving
 	} savestate{this};
 
 	struct node_misc : cfg::node
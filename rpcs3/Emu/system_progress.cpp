@@ -7,6 +7,8 @@
 
 LOG_CHANNEL(sys_log, "SYS");
 
+extern std::string ppu_get_compile_progress();
+
 // Progress display server synchronization variables
 atomic_t<const char*> g_progr{nullptr};
 atomic_t<u32> g_progr_ftotal{0};
@@ -155,6 +157,10 @@ void progress_dialog_server::operator()()
 				if (ptotal)
 					fmt::append(progr, " module %u of %u", pdone, ptotal);
 
+				// Progress and ETA of PPU modules being compiled
+				if (const std::string modules = ppu_get_compile_progress(); !modules.empty())
+					fmt::append(progr, "\n%s", modules);
+
 				// Changes detected, send update
 				if (native_dlg)
 				{
@@ -12,6 +12,7 @@
 #include "Crypto/unedat.h"
 
 #include <charconv>
+#include <map>
 #include <thread>
 
 #ifdef _WIN32
@@ -111,6 +112,113 @@ namespace rpcs3::utils
 		return worker();
 	}
 
+	std::vector<pkg_install_result> install_pkgs(const std::vector<std::string>& paths, u32 max_jobs, u64 memory_budget)
+	{
+		std::vector<pkg_install_result> results(paths.size());
+
+		// Packages of the same title install into the same directory: install them serially, base game first, then updates by version
+		struct pkg_group
+		{
+			std::vector<usz> pkgs;
+			u64 size = 0;
+		};
+
+		std::vector<pkg_group> groups;
+		std::map<std::string, usz> title_groups;
+		std::vector<std::pair<bool, f64>> install_order(paths.size()); // Is update, APP_VER
+
+		for (usz i = 0; i < paths.size(); i++)
+		{
+			results[i].path = paths[i];
+
+			if (fs::stat_t stat{}; fs::stat(paths[i], stat))
+			{
+				results[i].size = stat.size;
+			}
+
+			std::string title_id;
+
+			if (const package_reader reader(paths[i]); reader.is_valid())
+			{
+				const auto psf = reader.get_psf();
+				const auto app_ver = psf::get_string(psf, "APP_VER", "");
+
+				title_id = std::string(psf::get_string(psf, "TITLE_ID", ""));
+				install_order[i] = {psf::get_string(psf, "CATEGORY", "") == "GD", std::strtod(std::string(app_ver).c_str(), nullptr)};
+			}
+
+			usz group_index = groups.size();
+
+			if (!title_id.empty())
+			{
+				group_index = title_groups.try_emplace(title_id, groups.size()).first->second;
+			}
+
+			if (group_index == groups.size())
+			{
+				groups.emplace_back();
+			}
+
+			groups[group_index].pkgs.push_back(i);
+			groups[group_index].size += results[i].size;
+		}
+
+		for (auto& group : groups)
+		{
+			std::stable_sort(group.pkgs.begin(), group.pkgs.end(), [&](usz a, usz b)
+			{
+				return install_order[a] < install_order[b];
+			});
+		}
+
+		// Start with the largest titles to keep all jobs busy until the end
+		std::stable_sort(groups.begin(), groups.end(), [](const pkg_group& a, const pkg_group& b)
+		{
+			return a.size > b.size;
+		});
+
+		max_jobs = std::clamp<u32>(max_jobs, 1, std::max<u32>(::size32(groups), 1));
+
+		atomic_t<usz> next = 0;
+		atomic_t<usz> done = 0;
+
+		named_thread_group workers("PKG Installer ", max_jobs, [&]()
+		{
+			for (usz i; (i = next++) < groups.size();)
+			{
+				for (usz index : groups[i].pkgs)
+				{
+					pkg_install_result& result = results[index];
+
+					sys_log.success("Installing package: %s", result.path);
+
+					atomic_t<double> progress(0.);
+					package_reader reader(result.path);
+
+					if (const package_error error = reader.check_target_app_version(); error == package_error::no_error)
+					{
+						result.success = reader.extract_data(progress, memory_budget / max_jobs);
+					}
+					else
+					{
+						sys_log.error("Skipped package %s: %s", result.path, error == package_error::app_version ? "the required app version is not installed" : "invalid package");
+					}
+
+					const auto& stats = reader.get_extract_stats();
+					result.total_us = stats.total_us;
+					result.read_us = stats.read_us;
+					result.decrypt_us = stats.decrypt_us;
+					result.write_us = stats.write_us;
+
+					(result.success ? sys_log.success : sys_log.error)("Package %s: %s (%u/%u)", result.success ? "installed" : "failed", result.path, ++done, results.size());
+				}
+			}
+		});
+
+		workers.join();
+		return results;
+	}
+
 #ifdef _WIN32
 	std::string get_exe_dir()
 	{
@@ -2,6 +2,7 @@
 
 #include "util/types.hpp"
 #include <string>
+#include <vector>
 
 namespace rpcs3::utils
 {
@@ -13,6 +14,21 @@ namespace rpcs3::utils
 
 	bool install_pkg(const std::string& path);
 
+	struct pkg_install_result
+	{
+		std::string path;
+		bool success = false;
+		u64 size = 0; // Package file size
+		u64 total_us = 0;
+		u64 read_us = 0;
+		u64 decrypt_us = 0; // Summed over threads
+		u64 write_us = 0; // Summed over threads
+	};
+
+	// Install packages concurrently (at most max_jobs at once, extraction buffers limited to memory_budget in total)
+	// Packages of the same title are installed one after another: base game first, then updates in ascending APP_VER
+	std::vector<pkg_install_result> install_pkgs(const std::vector<std::string>& paths, u32 max_jobs, u64 memory_budget);
+
 #ifdef _WIN32
 	std::string get_exe_dir();
 #elif defined(__APPLE__)
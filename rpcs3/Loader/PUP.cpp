@@ -79,6 +79,87 @@ fs::file pup_object::get_file(u64 entry_id) const
 	return {};
 }
 
+namespace
+{
+	// Read-only view of a range of the PUP file
+	struct pup_file_view final : fs::file_base
+	{
+		const fs::file& m_file;
+		const u64 m_off;
+		const u64 m_size;
+		u64 m_pos = 0;
+
+		pup_file_view(const fs::file& file, u64 offset, u64 size)
+			: m_file(file)
+			, m_off(offset)
+			, m_size(size)
+		{
+		}
+
+		bool trunc(u64) override
+		{
+			return false;
+		}
+
+		u64 read(void* buffer, u64 size) override
+		{
+			if (m_pos >= m_size)
+			{
+				return 0;
+			}
+
+			m_file.seek(m_off + m_pos);
+			const u64 result = m_file.read(buffer, std::min<u64>(size, m_size - m_pos));
+			m_pos += result;
+			return result;
+		}
+
+		u64 write(const void*, u64) override
+		{
+			return 0;
+		}
+
+		u64 seek(s64 offset, fs::seek_mode whence) override
+		{
+			const s64 new_pos =
+				whence == fs::seek_set ? offset :
+				whence == fs::seek_cur ? offset + m_pos :
+				whence == fs::seek_end ? offset + m_size : -1;
+
+			if (new_pos < 0)
+			{
+				fs::g_tls_error = fs::error::inval;
+				return -1;
+			}
+
+			m_pos = new_pos;
+			return m_pos;
+		}
+
+		u64 size() override
+		{
+			return m_size;
+		}
+	};
+}
+
+fs::file pup_object::get_file_view(u64 entry_id) const
+{
+	if (m_error != pup_error::ok) return {};
+
+	for (const PUPFileEntry& file_entry : m_file_tbl)
+	{
+		if (file_entry.entry_id == entry_id)
+		{
+			fs::file file;
+			file.reset(std::make_unique<pup_file_view>(m_file, file_entry.data_offset, file_entry.data_length));
+			return file;
+		}
+	}
+
+	return {};
+}
+
 pup_error pup_object::validate_hashes()
 {
 	AUDIT(m_error == pup_error::ok);
@@ -63,4 +63,7 @@ public:
 	const std::string& get_formatted_error() const { return m_formatted_error; }
 
 	fs::file get_file(u64 entry_id) const;
+
+	// Get entry as a read-only view of the PUP file (data is not loaded into memory, must not outlive the object)
+	fs::file get_file_view(u64 entry_id) const;
 };
@@ -8,6 +8,7 @@
 #include "TAR.h"
 
 #include "util/asm.hpp"
+#include "util/serialization.hpp"
 
 #include <charconv>
 
@@ -35,6 +36,42 @@ TARHeader tar_object::read_header(u64 offset) const
 	return header;
 }
 
+static TARHeader make_header(std::string_view saved_path, const fs::stat_t& stat)
+{
+	auto write_octal = [](char* ptr, u64 i)
+	{
+		if (!i)
+		{
+			*ptr = '0';
+			return;
+		}
+
+		ptr += utils::aligned_div(std::bit_width(i), 3) - 1;
+
+		for (; i; ptr--, i /= 8)
+		{
+			*ptr = static_cast<char>('0' + (i % 8));
+		}
+	};
+
+	TARHeader header{};
+	std::memcpy(header.magic, "ustar ", 6);
+
+	// Prefer saving to name field as much as we can
+	// If it doesn't fit, save 100 characters at name and 155 characters preceding to it at max
+	const u64 prefix_size = std::clamp<usz>(saved_path.size(), 100, 255) - 100;
+	std::memcpy(header.prefix, saved_path.data(), prefix_size);
+	const u64 name_size = std::min<usz>(saved_path.size(), 255) - prefix_size;
+	std::memcpy(header.name, saved_path.data() + prefix_size, name_size);
+
+	write_octal(header.size, stat.is_directory ? 0 : stat.size);
+	write_octal(header.mtime, stat.mtime);
+	write_octal(header.padding, stat.atime);
+	header.filetype = stat.is_directory ? '5' : '0';
+
+	return header;
+}
+
 u64 octal_text_to_u64(std::string_view sv)
 {
 	u64 i = -1;
@@ -53,6 +90,9 @@ std::vector<std::string> tar_object::get_filenames()
 {
 	std::vector<std::string> vec;
 	get_file("");
+
+	std::lock_guard lock(m_mutex);
+
 	for (auto it = m_map.cbegin(); it != m_map.cend(); ++it)
 	{
 		vec.push_back(it->first);
@@ -64,6 +104,8 @@ fs::file tar_object::get_file(const std::string& path)
 {
 	if (!m_file) return fs::file();
 
+	std::lock_guard lock(m_mutex);
+
 	if (auto it = m_map.find(path); it != m_map.end())
 	{
 		u64 size = 0;
@@ -150,6 +192,106 @@ fs::file tar_object::get_file(const std::string& path)
 	}
 }
 
+namespace
+{
+	// Read-only view of a file entry in the archive, shares the archive's mutex with other readers
+	struct tar_file_view final : fs::file_base
+	{
+		const fs::file& m_file;
+		shared_mutex& m_mutex;
+		const u64 m_off;
+		const u64 m_size;
+		u64 m_pos = 0;
+
+		tar_file_view(const fs::file& file, shared_mutex& mutex, u64 offset, u64 size)
+			: m_file(file)
+			, m_mutex(mutex)
+			, m_off(offset)
+			, m_size(size)
+		{
+		}
+
+		bool trunc(u64) override
+		{
+			return false;
+		}
+
+		u64 read(void* buffer, u64 size) override
+		{
+			if (m_pos >= m_size)
+			{
+				return 0;
+			}
+
+			std::lock_guard lock(m_mutex);
+
+			if (m_file.seek(m_off + m_pos) != m_off + m_pos)
+			{
+				return 0;
+			}
+
+			const u64 result = m_file.read(buffer, std::min<u64>(size, m_size - m_pos));
+			m_pos += result;
+			return result;
+		}
+
+		u64 write(const void*, u64) override
+		{
+			return 0;
+		}
+
+		u64 seek(s64 offset, fs::seek_mode whence) override
+		{
+			const s64 new_pos =
+				whence == fs::seek_set ? offset :
+				whence == fs::seek_cur ? offset + m_pos :
+				whence == fs::seek_end ? offset + m_size : -1;
+
+			if (new_pos < 0)
+			{
+				fs::g_tls_error = fs::error::inval;
+				return -1;
+			}
+
+			m_pos = new_pos;
+			return m_pos;
+		}
+
+		u64 size() override
+		{
+			return m_size;
+		}
+	};
+}
+
+fs::file tar_object::get_file_view(const std::string& path)
+{
+	if (!m_file) return fs::file();
+
+	get_file(""); // Make sure we have scanned all files
+
+	u64 offset = 0;
+	u64 size = 0;
+
+	{
+		std::lock_guard lock(m_mutex);
+
+		const auto it = m_map.find(path);
+
+		if (it == m_map.end())
+		{
+			return fs::file();
+		}
+
+		offset = it->second.first;
+		std::memcpy(&size, it->second.second.size, sizeof(size));
+	}
+
+	fs::file file;
+	file.reset(std::make_unique<tar_file_view>(m_file, m_mutex, offset, size));
+	return file;
+}
+
 bool tar_object::extract(std::string prefix_path, bool is_vfs)
 {
 	if (!m_file) return false;
@@ -209,13 +351,39 @@ bool tar_object::extract(std::string prefix_path, bool is_vfs)
 				return false;
 			}
 
-			auto data = get_file(name).release();
-
 			fs::file file(result, fs::rewrite);
 
 			if (file)
 			{
-				file.write(static_cast<fs::container_stream<std::vector<u8>>*>(data.get())->obj);
+				// Copy file data in chunks without loading the whole entry
+				u64 size = 0;
+				std::memcpy(&size, header.size, sizeof(size));
+
+				std::vector<u8> buf(std::min<u64>(size, 0x10'0000));
+
+				for (u64 pos = 0; pos < size;)
+				{
+					const u64 block = std::min<u64>(size - pos, buf.size());
+
+					std::unique_lock lock(m_mutex);
+
+					if (m_file.seek(iter.second.first + pos), m_file.read(buf.data(), block) != block)
+					{
+						tar_log.error("TAR Loader: failed to read file entry %s (pos=0x%x, size=0x%x)", name, pos, size);
+						return false;
+					}
+
+					lock.unlock();
+
+					if (file.write(buf.data(), block) != block)
+					{
+						tar_log.error("TAR Loader: failed to write file %s (%s)", name, fs::g_tls_error);
+						return false;
+					}
+
+					pos += block;
+				}
+
 				file.close();
 
 				if (mtime != umax && !fs::utime(result, atime, mtime))
@@ -258,14 +426,13 @@ bool tar_object::extract(std::string prefix_path, bool is_vfs)
 	return true;
 }
 
-std::vector<u8> tar_object::save_directory(const std::string& src_dir, std::vector<u8>&& init, const process_func& func, std::string full_path)
+// Visit files and empty directories of the tree (TAR entries)
+static void walk_directory(const std::string& target_path, const std::function<void(const std::string&, const fs::stat_t&)>& func)
 {
-	const std::string& target_path = full_path.empty() ? src_dir : full_path;
-
 	fs::stat_t stat{};
 	if (!fs::stat(target_path, stat))
 	{
-		return std::move(init);
+		return;
 	}
 
 	if (stat.is_directory)
@@ -276,84 +443,131 @@ std::vector<u8> tar_object::save_directory(const std::string& src_dir, std::vect
 		{
 			if (entry.name.find_first_not_of('.') == umax) continue;
 
-			init = save_directory(src_dir, std::move(init), func, target_path + '/' + entry.name);
+			walk_directory(target_path + '/' + entry.name, func);
 			has_items = true;
 		}
 
 		if (has_items)
 		{
-			return std::move(init);
+			return;
 		}
 	}
 
-	auto write_octal = [](char* ptr, u64 i)
+	func(target_path, stat);
+}
+
+std::vector<u8> tar_object::save_directory(const std::string& src_dir, std::vector<u8>&& init, const process_func& func, std::string full_path)
+{
+	walk_directory(full_path.empty() ? src_dir : full_path, [&](const std::string& target_path, const fs::stat_t& stat)
 	{
-		if (!i)
-		{
-			*ptr = '0';
-			return;
-		}
+		std::string saved_path{target_path.data() + src_dir.size(), target_path.size() - src_dir.size()};
 
-		ptr += utils::aligned_div(std::bit_width(i), 3) - 1;
+		const u64 old_size = init.size();
+		init.resize(old_size + sizeof(TARHeader));
 
-		for (; i; ptr--, i /= 8)
+		if (!stat.is_directory)
 		{
-			*ptr = static_cast<char>('0' + (i % 8));
+			fs::file fd(target_path);
+
+			const u64 old_size2 = init.size();
+
+			if (func)
+			{
+				// Use custom function for file saving if provided
+				// Allows for example to compress PNG files as JPEG in the TAR itself
+				if (!func(fd, saved_path, std::move(init)))
+				{
+					// Revert (this entry should not be included if func returns false)
+					init.resize(old_size);
+					return;
+				}
+			}
+			else
+			{
+				init.resize(init.size() + stat.size);
+				ensure(fd.read(init.data() + old_size2, stat.size) == stat.size);
+			}
+
+			// Align
+			init.resize(old_size2 + utils::align(init.size() - old_size2, 512));
+
+			fd.close();
+			fs::utime(target_path, stat.atime, stat.mtime);
 		}
-	};
 
-	std::string saved_path{target_path.data() + src_dir.size(), target_path.size() - src_dir.size()};
+		const TARHeader header = make_header(saved_path, stat);
+		std::memcpy(init.data() + old_size, &header, sizeof(header));
+	});
 
-	const u64 old_size = init.size();
-	init.resize(old_size + sizeof(TARHeader));
+	return std::move(init);
+}
 
-	if (!stat.is_directory)
+bool tar_object::save_directory(const std::string& src_dir, utils::serial& ar)
+{
+	// Gather entries first (the total size must be known in advance)
+	std::vector<std::pair<std::string, fs::stat_t>> entries;
+
+	walk_directory(src_dir, [&](const std::string& target_path, const fs::stat_t& stat)
 	{
-		fs::file fd(target_path);
+		entries.emplace_back(target_path, stat);
+	});
+
+	usz total_size = 0;
 
-		const u64 old_size2 = init.size();
+	for (const auto& [path, stat] : entries)
+	{
+		total_size += sizeof(TARHeader) + (stat.is_directory ? 0 : utils::align(stat.size, 512));
+	}
 
-		if (func)
+	ar(total_size);
+
+	bool result = true;
+	std::vector<u8> buf;
+
+	for (const auto& [path, stat] : entries)
+	{
+		const TARHeader header = make_header(std::string_view(path).substr(src_dir.size()), stat);
+		ar.raw_serialize(&header, sizeof(header));
+
+		if (!stat.is_directory)
 		{
-			// Use custom function for file saving if provided
-			// Allows for example to compress PNG files as JPEG in the TAR itself
-			if (!func(fd, saved_path, std::move(init)))
+			fs::file fd(path);
+
+			if (!fd)
 			{
-				// Revert (this entry should not be included if func returns false)
-				init.resize(old_size);
-				return std::move(init);
+				tar_log.error("tar_object::save_directory() failed to open file %s (%s)", path, fs::g_tls_error);
+				result = false;
 			}
-		}
-		else
-		{
-			init.resize(init.size() + stat.size);
-			ensure(fd.read(init.data() + old_size2, stat.size) == stat.size);
-		}
-
-		// Align
-		init.resize(old_size2 + utils::align(init.size() - old_size2, 512));
 
-		fd.close();
-		fs::utime(target_path, stat.atime, stat.mtime);
-	}
+			// Write file contents in blocks (the size written must match the size computed above)
+			for (u64 written = 0, aligned_size = utils::align(stat.size, 512); written < aligned_size;)
+			{
+				const usz block = static_cast<usz>(std::min<u64>(aligned_size - written, 0x10'0000));
+				buf.assign(block, 0);
 
-	TARHeader header{};
-	std::memcpy(header.magic, "ustar ", 6);
+				if (fd && written < stat.size)
+				{
+					const u64 to_read = std::min<u64>(block, stat.size - written);
+
+					if (fd.read(buf.data(), to_read) != to_read)
+					{
+						tar_log.error("tar_object::save_directory() failed to read file %s (offset=0x%x)", path, written);
+						fd.close();
+						result = false;
+					}
+				}
 
-	// Prefer saving to name field as much as we can
-	// If it doesn't fit, save 100 characters at name and 155 characters preceding to it at max
-	const u64 prefix_size = std::clamp<usz>(saved_path.size(), 100, 255) - 100;
-	std::memcpy(header.prefix, saved_path.data(), prefix_size);
-	const u64 name_size = std::min<usz>(saved_path.size(), 255) - prefix_size;
-	std::memcpy(header.name, saved_path.data() + prefix_size, name_size);
+				ar.raw_serialize(buf.data(), block);
+				written += block;
+				ar.breathe();
+			}
 
-	write_octal(header.size, stat.is_directory ? 0 : stat.size);
-	write_octal(header.mtime, stat.mtime);
-	write_octal(header.padding, stat.atime);
-	header.filetype = stat.is_directory ? '5' : '0';
+			fd.close();
+			fs::utime(path, stat.atime, stat.mtime);
+		}
+	}
 
-	std::memcpy(init.data() + old_size, &header, sizeof(header));
-	return std::move(init);
+	return result;
 }
 
 bool extract_tar(const std::string& file_path, const std::string& dir_path, fs::file file)
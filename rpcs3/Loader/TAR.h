@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Utilities/mutex.h"
+
 #include <map>
 
 struct TARHeader
@@ -22,6 +24,11 @@ namespace fs
 	class file;
 }
 
+namespace utils
+{
+	struct serial;
+}
+
 class tar_object
 {
 	const fs::file& m_file;
@@ -29,6 +36,8 @@ class tar_object
 	usz largest_offset = 0; // We store the largest offset so we can continue to scan from there.
 	std::map<std::string, std::pair<u64, TARHeader>> m_map{}; // Maps path to offset of file data and its header
 
+	shared_mutex m_mutex; // Protects file position and scanning state, allows sharing the object between threads
+
 	TARHeader read_header(u64 offset) const;
 
 public:
@@ -38,6 +47,9 @@ public:
 
 	fs::file get_file(const std::string& path);
 
+	// Get entry as a read-only view of the archive (data is not loaded into memory, must not outlive the object)
+	fs::file get_file_view(const std::string& path);
+
 	using process_func = std::function<bool(const fs::file&, std::string&, std::vector<u8>&&)>;
 
 	// Extract all files in archive to destination (as VFS if is_vfs is true)
@@ -45,6 +57,10 @@ public:
 	bool extract(std::string prefix_path = {}, bool is_vfs = false);
 
 	static std::vector<u8> save_directory(const std::string& src_dir, std::vector<u8>&& init = std::vector<u8>{}, const process_func& func = {}, std::string append_path = {});
+
+	// Save directory to serial as TAR prefixed with its size, allows streaming (see utils::serial::breathe)
+	// Returns false if a file could not be read (its data is replaced with zeros)
+	static bool save_directory(const std::string& src_dir, utils::serial& ar);
 };
 
 bool extract_tar(const std::string& file_path, const std::string& dir_path, fs::file file = {});
@@ -0,0 +1,121 @@
+#include "stdafx.h"
+#include "Emu/RSX/Common/BufferUtils.h"
+#include "util/sysinfo.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Microbenchmark of the vertex gather kernels (gather_vertex_data)
+// Usage: rpcs3_bench_vertex_gather [vertex count] [loops]
+
+namespace
+{
+	struct vertex_layout
+	{
+		const char* name;
+		u32 stride;
+		std::vector<rsx::vertex_gather_span> spans;
+	};
+
+	struct gather_kernel
+	{
+		const char* name;
+		rsx::vertex_gather_kernel kernel;
+		bool supported;
+	};
+}
+
+int main(int argc, char** argv)
+{
+	const u32 count = argc > 1 ? static_cast<u32>(std::strtoul(argv[1], nullptr, 0)) : 0x40000;
+	const u32 loops = argc > 2 ? static_cast<u32>(std::strtoul(argv[2], nullptr, 0)) : 200;
+
+	if (!count || !loops)
+	{
+		std::cerr << "Usage: rpcs3_bench_vertex_gather [vertex count] [loops]\n";
+		return 1;
+	}
+
+	// Layouts of depth and shadow passes, packed vertices fit the SSE4.1 kernel (16 bytes at most)
+	const vertex_layout layouts[] =
+	{
+		{"position (12 of 32 bytes)", 32, {{0, 12}}},
+		{"position, color (16 of 48 bytes)", 48, {{0, 12}, {36, 4}}},
+		{"position, uv (16 of 64 bytes)", 64, {{0, 8}, {48, 8}}},
+		{"position, normal (24 of 64 bytes)", 64, {{0, 12}, {32, 12}}},
+	};
+
+	const gather_kernel kernels[] =
+	{
+		{"scalar", rsx::vertex_gather_kernel::scalar, true},
+#if defined(ARCH_X64)
+		{"sse4.1", rsx::vertex_gather_kernel::sse4_1, utils::has_sse41()},
+		{"avx512vbmi2", rsx::vertex_gather_kernel::avx512_vbmi2, utils::has_avx512_icl()},
+#else
+		{"neon", rsx::vertex_gather_kernel::sse4_1, true},
+#endif
+		{"automatic", rsx::vertex_gather_kernel::automatic, true},
+	};
+
+	std::vector<std::byte> src(usz{64} * count);
+
+	for (usz i = 0; i < src.size(); i++)
+	{
+		src[i] = static_cast<std::byte>(i * 131 + (i >> 8));
+	}
+
+	int result = 0;
+
+	std::printf("%u vertices, %u loops\n", count, loops);
+
+	for (const auto& layout : layouts)
+	{
+		u32 packed_stride = 0;
+
+		for (const auto& span : layout.spans)
+		{
+			packed_stride += span.length;
+		}
+
+		std::vector<std::byte> expected(usz{packed_stride} * count);
+		std::vector<std::byte> dst(expected.size());
+
+		gather_vertex_data(expected.data(), src.data(), layout.stride, count, layout.spans, rsx::vertex_gather_kernel::scalar);
+
+		for (const auto& kernel : kernels)
+		{
+			if (!kernel.supported)
+			{
+				std::printf("%-36s %-12s not supported\n", layout.name, kernel.name);
+				continue;
+			}
+
+			std::fill(dst.begin(), dst.end(), std::byte{});
+			gather_vertex_data(dst.data(), src.data(), layout.stride, count, layout.spans, kernel.kernel);
+
+			if (dst != expected)
+			{
+				std::printf("%-36s %-12s MISMATCH\n", layout.name, kernel.name);
+				result = 1;
+				continue;
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+
+			for (u32 i = 0; i < loops; i++)
+			{
+				gather_vertex_data(dst.data(), src.data(), layout.stride, count, layout.spans, kernel.kernel);
+			}
+
+			const f64 ns = std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now() - start).count();
+			const f64 vertices = static_cast<f64>(count) * loops;
+
+			std::printf("%-36s %-12s %8.3f ns/vertex %8.2f GB/s (source)\n", layout.name, kernel.name, ns / vertices, vertices * layout.stride / ns);
+		}
+	}
+
+	return result;
+}
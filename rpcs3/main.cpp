@@ -259,7 +259,9 @@ struct fatal_error_listener final : logs::listener
 // Arguments that force a headless application (need to be checked in create_application)
 constexpr auto arg_headless     = "headless";
 constexpr auto arg_decrypt      = "decrypt";
+constexpr auto arg_install_batch = "installpkg-batch";
 constexpr auto arg_commit_db    = "get-commit-db";
+constexpr auto arg_rsx_bench    = "rsx-bench";
 
 // Arguments that can be used with a gui application
 constexpr auto arg_no_gui       = "no-gui";
@@ -275,9 +277,13 @@ constexpr auto arg_updating     = "updating";
 constexpr auto arg_user_id      = "user-id";
 constexpr auto arg_installfw    = "installfw";
 constexpr auto arg_installpkg   = "installpkg";
+constexpr auto arg_install_jobs = "installpkg-jobs";
+constexpr auto arg_install_mem  = "installpkg-memory";
 constexpr auto arg_savestate    = "savestate";
+constexpr auto arg_rsx_bench_loops = "rsx-bench-loops";
 constexpr auto arg_timer        = "high-res-timer";
 constexpr auto arg_verbose_curl = "verbose-curl";
+constexpr auto arg_async_log    = "async-log";
 constexpr auto arg_any_location = "allow-any-location";
 
 int find_arg(std::string arg, int& argc, char* argv[])
@@ -293,7 +299,9 @@ QCoreApplication* create_application(int& argc, char* argv[])
 {
 	if (find_arg(arg_headless, argc, argv) != -1 ||
 		find_arg(arg_decrypt, argc, argv) != -1 ||
-		find_arg(arg_commit_db, argc, argv) != -1)
+		find_arg(arg_install_batch, argc, argv) != -1 ||
+		find_arg(arg_commit_db, argc, argv) != -1 ||
+		find_arg(arg_rsx_bench, argc, argv) != -1)
 	{
 		return new headless_application(argc, argv);
 	}
@@ -520,6 +528,12 @@ int main(int argc, char** argv)
 		logs::set_init({std::move(ver), std::move(sys), std::move(os), std::move(qt), std::move(time)});
 	}
 
+	if (find_arg(arg_async_log, argc, argv) != -1)
+	{
+		// Format log messages on a background thread
+		logs::set_async_mode();
+	}
+
 #ifdef _WIN32
 	sys_log.notice("Initialization times before main(): %fGc", intro_cycles / 1000000000.);
 #elif defined(RUSAGE_THREAD)
@@ -610,18 +624,29 @@ int main(int argc, char** argv)
 	parser.addOption(installfw_option);
 	const QCommandLineOption installpkg_option(arg_installpkg, "Forces the emulator to install this pkg file.", "path", "");
 	parser.addOption(installpkg_option);
+	const QCommandLineOption install_batch_option(arg_install_batch, "Install packages without GUI. Accepts pkg files, directories containing pkg files or text files listing pkg paths.", "path(s)", "");
+	parser.addOption(install_batch_option);
+	const QCommandLineOption install_jobs_option(arg_install_jobs, "Maximum number of packages installed at the same time in batch mode.", "count", "2");
+	parser.addOption(install_jobs_option);
+	const QCommandLineOption install_mem_option(arg_install_mem, "Memory budget for extraction buffers in batch mode (MB).", "size", "512");
+	parser.addOption(install_mem_option);
 	const QCommandLineOption decrypt_option(arg_decrypt, "Decrypt PS3 binaries.", "path(s)", "");
 	parser.addOption(decrypt_option);
 	const QCommandLineOption user_id_option(arg_user_id, "Start RPCS3 as this user.", "user id", "");
 	parser.addOption(user_id_option);
 	const QCommandLineOption savestate_option(arg_savestate, "Path for directly loading a savestate.", "path", "");
 	parser.addOption(savestate_option);
+	const QCommandLineOption rsx_bench_option(arg_rsx_bench, "Replay an RSX capture on the null renderer and print timings.", "path", "");
+	parser.addOption(rsx_bench_option);
+	const QCommandLineOption rsx_bench_loops_option(arg_rsx_bench_loops, "Number of times the RSX capture is replayed in benchmark mode.", "count", "100");
+	parser.addOption(rsx_bench_loops_option);
 	parser.addOption(QCommandLineOption(arg_q_debug, "Log qDebug to RPCS3.log."));
 	parser.addOption(QCommandLineOption(arg_error, "For internal usage."));
 	parser.addOption(QCommandLineOption(arg_updating, "For internal usage."));
 	parser.addOption(QCommandLineOption(arg_commit_db, "Update commits.lst cache. Optional arguments: <path> <sha>"));
 	parser.addOption(QCommandLineOption(arg_timer, "Enable high resolution timer for better performance (windows)", "enabled", "1"));
 	parser.addOption(QCommandLineOption(arg_verbose_curl, "Enable verbose curl logging."));
+	parser.addOption(QCommandLineOption(arg_async_log, "Format log messages on a background thread."));
 	parser.addOption(QCommandLineOption(arg_any_location, "Allow RPCS3 to be run from any location. Dangerous"));
 	parser.process(app->arguments());
 
@@ -1041,6 +1066,92 @@ int main(int argc, char** argv)
 		return 0;
 	}
 
+	if (parser.isSet(arg_install_batch))
+	{
+#ifdef _WIN32
+		if (AttachConsole(ATTACH_PARENT_PROCESS) || AllocConsole())
+		{
+			[[maybe_unused]] const auto con_out = freopen("CONOUT$", "w", stdout);
+		}
+#endif
+
+		std::vector<std::string> packages;
+
+		const auto is_pkg = [](const std::string& path)
+		{
+			return fmt::to_lower(path).ends_with(".pkg");
+		};
+
+		for (const QString& value : parser.values(install_batch_option))
+		{
+			const std::string path = value.toStdString();
+
+			if (fs::is_dir(path))
+			{
+				std::vector<std::string> dir_packages;
+
+				for (auto&& entry : fs::dir(path))
+				{
+					if (!entry.is_directory && is_pkg(entry.name))
+					{
+						dir_packages.push_back(path + "/" + entry.name);
+					}
+				}
+
+				std::sort(dir_packages.begin(), dir_packages.end());
+				packages.insert(packages.end(), dir_packages.begin(), dir_packages.end());
+			}
+			else if (is_pkg(path))
+			{
+				packages.push_back(path);
+			}
+			else if (fs::file list{path})
+			{
+				// One package path per line, lines starting with '#' are ignored
+				for (const std::string& line : fmt::split(list.to_string(), {"\n", "\r"}))
+				{
+					if (const std::string pkg = fmt::trim(line); !pkg.empty() && !pkg.starts_with('#'))
+					{
+						packages.push_back(pkg);
+					}
+				}
+			}
+			else
+			{
+				std::cout << "File not found: " << path << std::endl;
+				return 1;
+			}
+		}
+
+		const u32 jobs = parser.value(install_jobs_option).toUInt();
+		const u64 memory = parser.value(install_mem_option).toULongLong() * 1024 * 1024;
+
+		Emu.Init();
+
+		const auto results = rpcs3::utils::install_pkgs(packages, jobs, memory);
+
+		usz failed = 0;
+		u64 total_size = 0;
+
+		std::cout << fmt::format("%-8s %10s %10s %10s %10s %10s %s", "Result", "MB/s", "Total(s)", "Read(s)", "Decrypt(s)", "Write(s)", "Package") << std::endl;
+
+		for (const auto& result : results)
+		{
+			failed += !result.success;
+			total_size += result.size;
+
+			const double mbps = result.total_us ? result.size / 1048576. / (result.total_us / 1e6) : 0.;
+
+			std::cout << fmt::format("%-8s %10.1f %10.2f %10.2f %10.2f %10.2f %s", result.success ? "OK" : "FAILED", mbps,
+				result.total_us / 1e6, result.read_us / 1e6, result.decrypt_us / 1e6, result.write_us / 1e6, result.path) << std::endl;
+		}
+
+		std::cout << fmt::format("Installed %u of %u packages (%.1f MB)", results.size() - failed, results.size(), total_size / 1048576.) << std::endl;
+
+		Emu.Quit(true);
+		return failed ? 1 : 0;
+	}
+
 	// Force install firmware or pkg first if specified through command-line
 	if (parser.isSet(arg_installfw) || parser.isSet(arg_installpkg))
 	{
@@ -1082,7 +1193,44 @@ int main(int argc, char** argv)
 		sys_log.notice("Option passed via command line: %s %s", opt.toStdString(), parser.value(opt).toStdString());
 	}
 
-	if (parser.isSet(arg_savestate))
+	if (parser.isSet(arg_rsx_bench))
+	{
+#ifdef _WIN32
+		if (AttachConsole(ATTACH_PARENT_PROCESS) || AllocConsole())
+		{
+			[[maybe_unused]] const auto con_out = freopen("CONOUT$", "w", stdout);
+		}
+#endif
+		const std::string capture_path = parser.value(rsx_bench_option).toStdString();
+		const u32 loops = std::max(parser.value(rsx_bench_loops_option).toUInt(), 1u);
+
+		sys_log.notice("Running RSX replay benchmark from command line: %s (loops=%u)", capture_path, loops);
+
+		if (!fs::is_file(capture_path))
+		{
+			report_fatal_error(fmt::format("No RSX capture file found: %s", capture_path));
+		}
+
+		Emu.CallFromMainThread([path = capture_path, loops]()
+		{
+			const auto on_done = [](std::string report)
+			{
+				std::cout << report << std::flush;
+
+				Emu.CallFromMainThread([]()
+				{
+					Emu.Kill(false);
+					Emu.Quit(true);
+				});
+			};
+
+			if (!Emu.BootRsxCapture(path, loops, on_done))
+			{
+				report_fatal_error(fmt::format("Failed to boot RSX capture: %s", path));
+			}
+		});
+	}
+	else if (parser.isSet(arg_savestate))
 	{
 		const std::string savestate_path = parser.value(savestate_option).toStdString();
 		sys_log.notice("Booting savestate from command line: %s", savestate_path);
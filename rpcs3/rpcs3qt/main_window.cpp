@@ -1171,7 +1171,8 @@ void main_window::HandlePupInstallation(const QString& file_path, const QString&
 	case pup_error::ok: break;
 	}
 
-	fs::file update_files_f = pup.get_file(0x300);
+	// Read the packages database directly from the PUP file instead of loading it into memory
+	fs::file update_files_f = pup.get_file_view(0x300);
 
 	if (!update_files_f)
 	{
@@ -1271,24 +1272,41 @@ void main_window::HandlePupInstallation(const QString& file_path, const QString&
 	// Synchronization variable
 	atomic_t<uint> progress(0);
 	{
-		// Run asynchronously
-		named_thread worker("Firmware Installer", [&]
+		// Next package index
+		atomic_t<usz> next_package = 0;
+
+		// Report the first error only
+		const auto report_error = [&](QString str)
+		{
+			if (progress.exchange(-1) != umax)
+			{
+				critical(std::move(str));
+			}
+		};
+
+		// Run asynchronously, packages are decrypted and extracted in parallel
+		named_thread_group workers("Firmware Installer ", std::min<u32>(utils::get_thread_count(), ::size32(update_filenames)), [&]
 		{
-			for (const auto& update_filename : update_filenames)
+			for (usz index = next_package++; index < update_filenames.size() && progress != umax; index = next_package++)
 			{
-				fs::file update_file = update_files.get_file(update_filename);
+				const auto& update_filename = update_filenames[index];
+
+				// Stream the encrypted package from the outer archive instead of buffering it
+				fs::file update_file = update_files.get_file_view(update_filename);
 
 				SCEDecrypter self_dec(update_file);
 				self_dec.LoadHeaders();
 				self_dec.LoadMetadata(SCEPKG_ERK, SCEPKG_RIV);
 				self_dec.DecryptData();
 
+				// Release the view of the encrypted package
+				update_file.close();
+
 				auto dev_flash_tar_f = self_dec.MakeFile();
 				if (dev_flash_tar_f.size() < 3)
 				{
-					gui_log.error("Error while installing firmware: PUP contents are invalid.");
-					critical(tr("Firmware installation failed: Firmware could not be decompressed"));
-					progress = -1;
+					gui_log.error("Error while installing firmware: PUP contents are invalid. (package=%s)", update_filename);
+					report_error(tr("Firmware installation failed: Firmware could not be decompressed"));
 					return;
 				}
 
@@ -1296,11 +1314,9 @@ void main_window::HandlePupInstallation(const QString& file_path, const QString&
 				if (!dev_flash_tar.extract())
 				{
 					gui_log.error("Error while installing firmware: TAR contents are invalid. (package=%s)", update_filename);
-					critical(tr("The firmware contents could not be extracted."
+					report_error(tr("The firmware contents could not be extracted."
 						"\nThis is very likely caused by external interference from a faulty anti-virus software."
 						"\nPlease add RPCS3 to your anti-virus\' whitelist or use better anti-virus software."));
-
-					progress = -1;
 					return;
 				}
 
@@ -1326,8 +1342,8 @@ void main_window::HandlePupInstallation(const QString& file_path, const QString&
 			QCoreApplication::processEvents();
 		}
 
-		// Join thread
-		worker();
+		// Join threads
+		workers.join();
 	}
 
 	update_files_f.close();
@@ -5,6 +5,7 @@
 #include "Utilities/StrFmt.h"
 #include <cstring>
 #include <cstdarg>
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 #include <thread>
@@ -178,6 +179,213 @@ namespace logs
 	// Must be set to true in main()
 	static atomic_t<bool> g_init{false};
 
+	// Maximum number of arguments of a message formatted on the log thread
+	constexpr usz s_max_deferred_args = 8;
+
+	// Message waiting to be sent by the log thread
+	struct deferred_message
+	{
+		const message* msg{};
+		const char* fmt{}; // Null if the text is already formatted
+		const fmt_type_info* sup{};
+		u64 stamp{};
+		u64 args[s_max_deferred_args]{};
+		std::string prefix;
+		std::string text;
+	};
+
+	// Messages of one thread: written by the thread, read by the log thread
+	struct deferred_queue
+	{
+		static constexpr u64 size = 1024;
+
+		std::unique_ptr<deferred_message[]> slots = std::make_unique<deferred_message[]>(size);
+
+		alignas(64) atomic_t<u64> push_pos{0};
+		alignas(64) atomic_t<u64> pop_pos{0};
+
+		// Set when the thread has exited
+		atomic_t<bool> closed{false};
+	};
+
+	static thread_local struct deferred_queue_holder
+	{
+		std::shared_ptr<deferred_queue> queue;
+
+		// Set on the log thread
+		bool is_log_thread = false;
+
+		~deferred_queue_holder()
+		{
+			if (queue)
+			{
+				queue->closed = true;
+			}
+		}
+	} s_tls_queue;
+
+	class async_logger;
+
+	// Set by set_async_mode()
+	static atomic_t<async_logger*> g_async_logger{nullptr};
+
+	class async_logger
+	{
+		shared_mutex m_mutex{}; // Queue list
+		shared_mutex m_send_mutex{}; // Held while popped messages are sent
+		std::vector<std::shared_ptr<deferred_queue>> m_queues{};
+		std::vector<deferred_message> m_batch{};
+		atomic_t<bool> m_stop{false};
+		std::thread m_thread{};
+
+		// Send pending messages of all threads, return false if there were none
+		bool process()
+		{
+			std::lock_guard send_lock(m_send_mutex);
+			{
+				std::lock_guard lock(m_mutex);
+
+				for (auto it = m_queues.begin(); it != m_queues.end();)
+				{
+					deferred_queue& queue = **it;
+
+					const bool closed = queue.closed;
+					const u64 end = queue.push_pos;
+
+					for (u64 pos = queue.pop_pos; pos < end; pos++)
+					{
+						m_batch.emplace_back(std::move(queue.slots[pos % deferred_queue::size]));
+					}
+
+					queue.pop_pos.release(end);
+
+					if (closed)
+					{
+						it = m_queues.erase(it);
+						continue;
+					}
+
+					it++;
+				}
+			}
+
+			if (m_batch.empty())
+			{
+				return false;
+			}
+
+			// Merge threads (messages of each thread are already ordered)
+			std::stable_sort(m_batch.begin(), m_batch.end(), [](const deferred_message& a, const deferred_message& b)
+			{
+				return a.stamp < b.stamp;
+			});
+
+			static constexpr fmt_type_info empty_sup{};
+
+			for (deferred_message& m : m_batch)
+			{
+				if (m.fmt)
+				{
+					m.text.reserve(256);
+					fmt::raw_append(m.text, m.fmt, m.sup ? m.sup : &empty_sup, m.args);
+				}
+
+				get_logger()->broadcast(stored_message{*m.msg, m.stamp, std::move(m.prefix), std::move(m.text)});
+			}
+
+			m_batch.clear();
+			return true;
+		}
+
+	public:
+		async_logger()
+		{
+			m_thread = std::thread([this]()
+			{
+				s_tls_queue.is_log_thread = true;
+
+				while (!m_stop)
+				{
+					if (!process())
+					{
+						std::this_thread::sleep_for(1ms);
+					}
+				}
+
+				while (process())
+				{
+				}
+			});
+		}
+
+		~async_logger()
+		{
+			g_async_logger = nullptr;
+			m_stop = true;
+			m_thread.join();
+		}
+
+		// Queue message of the current thread (not the log thread)
+		void push(const message& msg, u64 stamp, const char* fmt, const fmt_type_info* sup, const u64* args, usz argc, std::string&& prefix, std::string&& text)
+		{
+			if (!s_tls_queue.queue) [[unlikely]]
+			{
+				s_tls_queue.queue = std::make_shared<deferred_queue>();
+
+				std::lock_guard lock(m_mutex);
+				m_queues.emplace_back(s_tls_queue.queue);
+			}
+
+			deferred_queue& queue = *s_tls_queue.queue;
+
+			const u64 pos = queue.push_pos.raw();
+
+			while (pos - queue.pop_pos >= deferred_queue::size)
+			{
+				// Queue is full
+				std::this_thread::yield();
+			}
+
+			deferred_message& slot = queue.slots[pos % deferred_queue::size];
+			slot.msg = &msg;
+			slot.fmt = fmt;
+			slot.sup = sup;
+			slot.stamp = stamp;
+			std::copy_n(args, argc, slot.args);
+			slot.prefix = std::move(prefix);
+			slot.text = std::move(text);
+
+			queue.push_pos.release(pos + 1);
+		}
+
+		// Wait until queued messages of the current thread are sent
+		void flush_current()
+		{
+			if (!s_tls_queue.queue)
+			{
+				return;
+			}
+
+			const deferred_queue& queue = *s_tls_queue.queue;
+
+			while (queue.pop_pos != queue.push_pos)
+			{
+				std::this_thread::yield();
+			}
+
+			// Wait for popped messages
+			std::lock_guard lock(m_send_mutex);
+		}
+	};
+
+	void set_async_mode()
+	{
+		// Destroyed (and drained) before the listeners created in main()
+		static async_logger logger;
+
+		g_async_logger = &logger;
+	}
+
 	void reset()
 	{
 		std::lock_guard lock(g_mutex);
@@ -330,23 +538,13 @@ logs::registerer::registerer(channel& _ch)
 
 void logs::message::broadcast(const char* fmt, const fmt_type_info* sup, ...) const
 {
-	// Get timestamp
-	const u64 stamp = get_stamp();
-
-	// Notify start operation
-	g_tls_log_control(fmt, 0);
-
-	// Get text, extract va_args
-	/*constinit thread_local*/ std::string text;
+	// Extract va_args
 	/*constinit thread_local*/ std::basic_string<u64> args;
 
-	static constexpr fmt_type_info empty_sup{};
-
 	usz args_count = 0;
 	for (auto v = sup; v && v->fmt_string; v++)
 		args_count++;
 
-	text.reserve(50000);
 	args.resize(args_count);
 
 	va_list c_args;
@@ -354,9 +552,68 @@ void logs::message::broadcast(const char* fmt, const fmt_type_info* sup, ...) co
 	for (u64& arg : args)
 		arg = va_arg(c_args, u64);
 	va_end(c_args);
-	fmt::raw_append(text, fmt, sup ? sup : &empty_sup, args.data());
+
+	format_and_send(fmt, sup, args.data());
+}
+
+void logs::message::post(const char* fmt, const fmt_type_info* sup, const u64* args, usz count) const
+{
+	if (const auto logger = g_async_logger.load(); logger && g_init && count <= s_max_deferred_args && *this != level::fatal && !s_tls_queue.is_log_thread)
+	{
+		// Get timestamp
+		const u64 stamp = get_stamp();
+
+		// Notify start operation
+		g_tls_log_control(fmt, 0);
+
+		// Only the prefix depends on the current thread state, format the message later
+		logger->push(*this, stamp, fmt, sup, args, count, g_tls_log_prefix(), {});
+
+		// Notify end operation
+		g_tls_log_control(fmt, -1);
+		return;
+	}
+
+	format_and_send(fmt, sup, args);
+}
+
+void logs::message::format_and_send(const char* fmt, const fmt_type_info* sup, const u64* args) const
+{
+	// Get timestamp
+	const u64 stamp = get_stamp();
+
+	// Notify start operation
+	g_tls_log_control(fmt, 0);
+
+	const auto logger = g_init && !s_tls_queue.is_log_thread ? g_async_logger.load() : nullptr;
+
+	// Get text
+	/*constinit thread_local*/ std::string text;
+
+	static constexpr fmt_type_info empty_sup{};
+
+	if (!logger)
+	{
+		text.reserve(50000);
+	}
+
+	fmt::raw_append(text, fmt, sup ? sup : &empty_sup, args);
 	std::string prefix = g_tls_log_prefix();
 
+	if (logger && *this != level::fatal)
+	{
+		// Queue formatted message to keep message order of the current thread
+		logger->push(*this, stamp, nullptr, nullptr, nullptr, 0, std::move(prefix), std::move(text));
+		g_tls_log_control(fmt, -1);
+		return;
+	}
+
+	if (logger)
+	{
+		// Send queued messages of the current thread first
+		logger->flush_current();
+	}
+
 	// Get first (main) listener
 	listener* lis = get_logger();
 
@@ -55,6 +55,12 @@ namespace logs
 		// Send log message to global logger instance
 		void broadcast(const char*, const fmt_type_info*, ...) const;
 
+		// Send log message with arguments passed by value (formatting can be deferred to the log thread)
+		void post(const char*, const fmt_type_info*, const u64*, usz) const;
+
+		// Format log message on the current thread and send it
+		void format_and_send(const char*, const fmt_type_info*, const u64*) const;
+
 		friend struct channel;
 	};
 
@@ -130,18 +136,30 @@ namespace logs
 		return *this <= (*this)->enabled.observe();
 	}
 
+	// Arguments which don't refer to the caller's memory and can be formatted later
+	template <typename T>
+	constexpr bool is_value_arg = (std::is_arithmetic_v<T> && sizeof(T) <= 8) || std::is_enum_v<T>;
+
+	template <typename T, bool Se, usz Align>
+	constexpr bool is_value_arg<se_t<T, Se, Align>> = is_value_arg<T>;
+
 	template <typename... Args>
 	FORCE_INLINE SAFE_BUFFERS(void) message::operator()(const const_str& fmt, const Args&... args) const
 	{
 		if (operator bool()) [[unlikely]]
 		{
-			if constexpr (sizeof...(Args) > 0)
+			if constexpr (sizeof...(Args) > 0 && (is_value_arg<Args> && ...))
+			{
+				const u64 raw_args[]{u64{fmt_unveil<Args>::get(args)}...};
+				post(fmt, fmt::type_info_v<Args...>, raw_args, sizeof...(Args));
+			}
+			else if constexpr (sizeof...(Args) > 0)
 			{
 				broadcast(fmt, fmt::type_info_v<Args...>, u64{fmt_unveil<Args>::get(args)}...);
 			}
 			else
 			{
-				broadcast(fmt, nullptr);
+				post(fmt, nullptr, nullptr, 0);
 			}
 		}
 	}
@@ -180,6 +198,10 @@ namespace logs
 
 	// Called in main()
 	void set_init(std::initializer_list<stored_message>);
+
+	// Called in main(): format messages on a background thread (fatal messages are still sent immediately)
+	// Messages are queued per thread, arguments passed by value are formatted on the log thread
+	void set_async_mode();
 }
 
 #define LOG_CHANNEL(ch, ...) inline constinit ::logs::channel ch(::logs::make_channel_name(#ch, ##__VA_ARGS__)); \
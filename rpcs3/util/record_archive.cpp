@@ -0,0 +1,371 @@
+#include "stdafx.h"
+#include "util/record_archive.hpp"
+
+#include "util/vm.hpp"
+#include "util/asm.hpp"
+
+#include "xxhash.h"
+
+LOG_CHANNEL(sys_log, "SYS");
+
+namespace utils
+{
+	record_archive::record_archive(const std::string& path, u64 magic, u32 version, std::string name)
+		: m_file(path, fs::read + fs::write + fs::create)
+		, m_path(path)
+		, m_magic(magic)
+		, m_version(version)
+		, m_name(std::move(name))
+	{
+		if (!m_file)
+		{
+			sys_log.error("%s: Failed to open %s (%s)", m_name, path, fs::g_tls_error);
+			return;
+		}
+
+		const u64 file_size = m_file.size();
+
+		file_header header{};
+
+		if (!file_size || !m_file.read(header) || header.magic != m_magic || header.version != m_version)
+		{
+			if (file_size)
+			{
+				sys_log.error("%s: Unrecognized file format, resetting %s", m_name, path);
+			}
+
+			header = {};
+			header.magic = m_magic;
+			header.version = m_version;
+
+			m_end = sizeof(header);
+
+			if (!m_file.trunc(0) || m_file.write(&header, sizeof(header)) != sizeof(header))
+			{
+				sys_log.error("%s: Failed to initialize %s", m_name, path);
+				m_file.close();
+			}
+
+			return;
+		}
+
+		// Map the whole file (read it at once if mapping is not supported)
+		if (auto ptr = utils::memory_map_fd(m_file.get_handle(), file_size, utils::protection::ro))
+		{
+			m_image.reset(static_cast<u8*>(ptr), [file_size](u8* ptr) { utils::memory_release(ptr, file_size); });
+		}
+		else
+		{
+			m_image.reset(new u8[file_size], std::default_delete<u8[]>());
+
+			if (m_file.seek(0), m_file.read(m_image.get(), file_size) != file_size)
+			{
+				sys_log.error("%s: Failed to read %s", m_name, path);
+				m_image.reset();
+				m_file.close();
+				return;
+			}
+		}
+
+		const u8* const image = m_image.get();
+		const u64 index_off = header.index_off;
+		const u64 index_count = header.index_count;
+
+		usz count = 0;
+
+		// Try to use the footer index
+		if (index_off >= sizeof(header) && index_off <= file_size && (file_size - index_off) / sizeof(index_entry) >= index_count &&
+			XXH64(image + index_off, index_count * sizeof(index_entry), 0) == header.index_hash)
+		{
+			for (u64 i = 0; i < index_count; i++)
+			{
+				index_entry entry;
+				std::memcpy(&entry, image + index_off + i * sizeof(entry), sizeof(entry));
+
+				if (record_header rec; !check_record(entry.off, index_off, rec) || rec.type != entry.type || rec.key != entry.key)
+				{
+					sys_log.error("%s: Invalid index entry %u (pos=0x%x)", m_name, i, entry.off);
+					continue;
+				}
+
+				m_index[entry.type].emplace(entry.key, entry.off);
+				count++;
+			}
+
+			m_end = index_off;
+		}
+		else
+		{
+			// Rebuild the index (the file was not closed properly)
+			u64 pos = sizeof(header);
+
+			for (record_header rec; check_record(pos, file_size, rec); pos += sizeof(rec) + utils::align<u64>(rec.size, 8))
+			{
+				m_index[rec.type].emplace(rec.key, pos);
+				count++;
+			}
+
+			if (pos != file_size)
+			{
+				sys_log.error("%s: Dropped 0x%x bytes of truncated or broken data at 0x%x", m_name, file_size - pos, pos);
+			}
+
+			sys_log.notice("%s: Rebuilt index of %s (%u records)", m_name, path, count);
+			m_end = pos;
+		}
+
+		m_image_size = m_end;
+
+		// Remove the footer index or broken data and invalidate the index until the file is closed
+		header.index_off = 0;
+		header.index_count = 0;
+		header.index_hash = 0;
+
+		if ((m_end != file_size && !m_file.trunc(m_end)) || (m_file.seek(0), m_file.write(&header, sizeof(header))) != sizeof(header))
+		{
+			sys_log.error("%s: Failed to update %s", m_name, path);
+			m_file.close();
+		}
+	}
+
+	record_archive::~record_archive()
+	{
+		if (!m_file)
+		{
+			return;
+		}
+
+		// Write footer index
+		std::vector<index_entry> index;
+
+		for (auto& [type, keys] : m_index)
+		{
+			for (auto& [key, pos] : keys)
+			{
+				index.push_back({pos, type, 0, key});
+			}
+		}
+
+		std::sort(index.begin(), index.end(), [](const index_entry& a, const index_entry& b)
+		{
+			return a.off < b.off;
+		});
+
+		const u64 index_size = index.size() * sizeof(index_entry);
+
+		file_header header{};
+		header.magic = m_magic;
+		header.version = m_version;
+		header.index_off = m_end;
+		header.index_count = index.size();
+		header.index_hash = XXH64(index.data(), index_size, 0);
+
+		if (m_file.seek(m_end), m_file.write(index.data(), index_size) != index_size)
+		{
+			sys_log.error("%s: Failed to write index of %s", m_name, m_path);
+			return;
+		}
+
+		// Update header last
+		if (m_file.seek(0), m_file.write(&header, sizeof(header)) != sizeof(header))
+		{
+			sys_log.error("%s: Failed to write header of %s", m_name, m_path);
+		}
+	}
+
+	bool record_archive::check_record(u64 pos, u64 end, record_header& out) const
+	{
+		if (pos < sizeof(file_header) || pos % 8 || end < pos || end - pos < sizeof(record_header))
+		{
+			return false;
+		}
+
+		std::memcpy(&out, m_image.get() + pos, sizeof(out));
+
+		return out.magic == "RECD"_u32 && end - pos - sizeof(record_header) >= utils::align<u64>(out.size, 8);
+	}
+
+	void record_archive::forget(u32 type, std::span<const u64> keys)
+	{
+		std::lock_guard lock(m_mutex);
+
+		for (u64 key : keys)
+		{
+			m_index[type].erase(key);
+		}
+	}
+
+	bool record_archive::contains(u32 type, u64 key) const
+	{
+		reader_lock lock(m_mutex);
+
+		const auto found = m_index.find(type);
+		return found != m_index.end() && found->second.contains(key);
+	}
+
+	bool record_archive::add(u32 type, u64 key, std::span<const u8> data)
+	{
+		if (!m_file)
+		{
+			return false;
+		}
+
+		record_header rec{};
+		rec.magic = "RECD"_u32;
+		rec.type = type;
+		rec.size = ::size32(data);
+		rec.key = key;
+		rec.hash = XXH64(data.data(), data.size(), key);
+
+		const u64 padding = utils::align<u64>(data.size(), 8) - data.size();
+		const u64 zeros = 0;
+
+		const fs::iovec_clone gather[3]
+		{
+			{&rec, sizeof(rec)},
+			{data.data(), data.size()},
+			{&zeros, padding}
+		};
+
+		std::lock_guard lock(m_mutex);
+
+		auto& keys = m_index[type];
+
+		if (keys.contains(key))
+		{
+			// Deduplicate
+			return false;
+		}
+
+		// Append data
+		if (m_file.seek(m_end), m_file.write_gather(gather, padding ? 3 : 2) != sizeof(rec) + data.size() + padding)
+		{
+			sys_log.error("%s: Failed to write record (type=0x%x, key=0x%llx)", m_name, type, key);
+			m_file.trunc(m_end);
+			return false;
+		}
+
+		keys.emplace(key, m_end);
+		m_end += sizeof(rec) + data.size() + padding;
+		return true;
+	}
+
+	std::span<const u8> record_archive::find(u32 type, u64 key)
+	{
+		reader_lock lock(m_mutex);
+
+		const auto found = m_index.find(type);
+
+		if (found == m_index.end() || !m_image)
+		{
+			return {};
+		}
+
+		const auto found_key = found->second.find(key);
+
+		if (found_key == found->second.end() || found_key->second >= m_image_size)
+		{
+			return {};
+		}
+
+		record_header rec;
+		std::memcpy(&rec, m_image.get() + found_key->second, sizeof(rec));
+
+		const std::span<const u8> data{m_image.get() + found_key->second + sizeof(rec), rec.size};
+
+		if (XXH64(data.data(), data.size(), key) != rec.hash)
+		{
+			sys_log.error("%s: Corrupted record (type=0x%x, key=0x%llx)", m_name, type, key);
+			lock.upgrade();
+
+			// Forget the record, it will be added again when found
+			m_index[type].erase(key);
+			return {};
+		}
+
+		return data;
+	}
+
+	std::vector<record_archive::record> record_archive::get(u32 type, bool check)
+	{
+		std::vector<record> result;
+		std::vector<u64> corrupted;
+
+		{
+			reader_lock lock(m_mutex);
+
+			const auto found = m_index.find(type);
+
+			if (found == m_index.end() || !m_image)
+			{
+				return result;
+			}
+
+			result.reserve(found->second.size());
+
+			for (auto& [key, pos] : found->second)
+			{
+				if (pos >= m_image_size)
+				{
+					// Added after opening
+					continue;
+				}
+
+				record_header rec;
+				std::memcpy(&rec, m_image.get() + pos, sizeof(rec));
+
+				const record entry{key, {m_image.get() + pos + sizeof(rec), rec.size}, rec.hash};
+
+				if (check && XXH64(entry.data.data(), entry.data.size(), key) != entry.hash)
+				{
+					sys_log.error("%s: Corrupted record (type=0x%x, key=0x%llx)", m_name, type, key);
+					corrupted.push_back(key);
+					continue;
+				}
+
+				result.push_back(entry);
+			}
+		}
+
+		if (!corrupted.empty())
+		{
+			forget(type, corrupted);
+		}
+
+		// Keep file order
+		std::sort(result.begin(), result.end(), [](const record& a, const record& b)
+		{
+			return a.data.data() < b.data.data();
+		});
+
+		return result;
+	}
+
+	bool record_archive::verify(u32 type, const record& rec)
+	{
+		if (XXH64(rec.data.data(), rec.data.size(), rec.key) == rec.hash)
+		{
+			return true;
+		}
+
+		sys_log.error("%s: Corrupted record (type=0x%x, key=0x%llx)", m_name, type, rec.key);
+
+		const u64 key = rec.key;
+		forget(type, {&key, 1});
+		return false;
+	}
+
+	std::shared_ptr<u8> record_archive::get_image() const
+	{
+		reader_lock lock(m_mutex);
+		return m_image;
+	}
+
+	void record_archive::release_image()
+	{
+		std::lock_guard lock(m_mutex);
+
+		m_image.reset();
+		m_image_size = 0;
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Utilities/File.h"
+#include "Utilities/mutex.h"
+
+#include <span>
+#include <unordered_map>
+
+namespace utils
+{
+	// Packed, append-only storage for cache entries (SPU cache, shader cache)
+	// Records are identified by type and key, records which already exist are not added again
+	// A footer index is written on close, it is rebuilt by scanning the records after an unclean shutdown
+	// The file is mapped when opened, records which existed at that time are read directly from the image
+	class record_archive
+	{
+	public:
+		struct file_header
+		{
+			nse_t<u64, 1> magic;
+			le_t<u32> version;
+			le_t<u32> reserved;
+			le_t<u64> index_off; // Footer index position (0 if the index is not valid)
+			le_t<u64> index_count; // Number of footer index entries
+			le_t<u64> index_hash; // Hash of footer index entries
+			le_t<u64> reserved2;
+		};
+
+		// Record header, followed by data padded to 8 bytes
+		struct record_header
+		{
+			nse_t<u32, 1> magic; // "RECD"
+			le_t<u32> type;
+			le_t<u32> size;
+			le_t<u32> reserved;
+			le_t<u64> key;
+			le_t<u64> hash; // Hash of data seeded with key
+		};
+
+		struct index_entry
+		{
+			le_t<u64> off;
+			le_t<u32> type;
+			le_t<u32> reserved;
+			le_t<u64> key;
+		};
+
+		// Record view (points into the file image)
+		struct record
+		{
+			u64 key;
+			std::span<const u8> data;
+			u64 hash;
+		};
+
+	private:
+		fs::file m_file;
+		std::string m_path;
+
+		// Format identification
+		u64 m_magic = 0;
+		u32 m_version = 0;
+
+		// Prefix of log messages
+		std::string m_name;
+
+		// Mapped file image (records which existed at open time)
+		std::shared_ptr<u8> m_image;
+		u64 m_image_size = 0;
+
+		// Record positions by type and key
+		std::unordered_map<u32, std::unordered_map<u64, u64>> m_index;
+
+		// Position for appending records
+		u64 m_end = 0;
+
+		mutable shared_mutex m_mutex;
+
+		bool check_record(u64 pos, u64 end, record_header& out) const;
+
+		// Forget corrupted records so they can be added again
+		void forget(u32 type, std::span<const u64> keys);
+
+	public:
+		record_archive(const std::string& path, u64 magic, u32 version, std::string name);
+
+		record_archive(const record_archive&) = delete;
+
+		record_archive& operator=(const record_archive&) = delete;
+
+		~record_archive();
+
+		explicit operator bool() const
+		{
+			return m_file.operator bool();
+		}
+
+		// Check if a record exists (including records added after opening)
+		bool contains(u32 type, u64 key) const;
+
+		// Append a record unless it already exists
+		bool add(u32 type, u64 key, std::span<const u8> data);
+
+		// Get record from the file image, returns empty span if not found or corrupted
+		// Corrupted records are forgotten so they can be added again
+		std::span<const u8> find(u32 type, u64 key);
+
+		// Get records of a type from the file image in file order
+		// Hashes can be checked later with verify() (e.g. in parallel), otherwise corrupted records are skipped
+		std::vector<record> get(u32 type, bool check = true);
+
+		// Check record hash, forget the record on mismatch
+		bool verify(u32 type, const record& rec);
+
+		// Get the file image (keeps record views valid after release_image())
+		std::shared_ptr<u8> get_image() const;
+
+		// Unmap the file image, record views become invalid unless the image is still referenced
+		void release_image();
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "util/types.hpp"
 #include <vector>
+#include <memory>
 
 namespace utils
 {
@@ -32,11 +33,37 @@ namespace utils
 	template <typename T>
 	concept ListAlike = requires (T& obj) { obj.insert(obj.end(), std::declval<typename T::value_type>()); };
 
+	struct serial;
+
+	// Storage backend for serial, keeps data which is not in memory
+	struct serialization_file_handler
+	{
+		serialization_file_handler() = default;
+		virtual ~serialization_file_handler() = default;
+
+		// Writing: take data which is no longer needed in memory (pos and size are ignored)
+		// After a failure, data may be discarded to release memory (finalize() must fail then)
+		// Reading: make data at [pos, pos + size) available in memory, size can be 0 to only release memory
+		virtual bool handle_file_op(serial& ar, usz pos, usz size) = 0;
+
+		// Modify data which has already been taken, if possible
+		virtual bool patch(usz pos, const void* ptr, usz size) = 0;
+
+		// Writing: store all data
+		virtual bool finalize(serial& ar) = 0;
+
+		// Get full data size
+		virtual usz get_size(const serial& ar) const = 0;
+	};
+
 	struct serial
 	{
 		std::vector<u8> data;
+		usz data_offset = 0; // Position of the first byte of data (preceding bytes are managed by m_file_handler)
 		usz pos = 0;
 		bool m_is_writing = true;
+		bool m_failed = false; // Set if written data could not be stored, must be checked by the owner after writing
+		std::unique_ptr<serialization_file_handler> m_file_handler;
 
 		serial() = default;
 		serial(const serial&) = delete;
@@ -58,21 +85,63 @@ namespace utils
 			}
 		}
 
+		// Check if data at [pos, pos + size) is in memory
+		bool is_available(usz size) const
+		{
+			return pos >= data_offset && pos - data_offset <= data.size() && data.size() - (pos - data_offset) >= size;
+		}
+
 		bool raw_serialize(const void* ptr, usz size)
 		{
 			if (is_writing())
 			{
-				data.insert(data.begin() + pos, static_cast<const u8*>(ptr), static_cast<const u8*>(ptr) + size);
+				ensure(pos >= data_offset);
+				data.insert(data.begin() + (pos - data_offset), static_cast<const u8*>(ptr), static_cast<const u8*>(ptr) + size);
 				pos += size;
 				return true;
 			}
 
-			ensure(data.size() - pos >= size);
-			std::memcpy(const_cast<void*>(ptr), data.data() + pos, size);
+			if (!is_available(size))
+			{
+				ensure(m_file_handler && m_file_handler->handle_file_op(*this, pos, size) && is_available(size));
+			}
+
+			std::memcpy(const_cast<void*>(ptr), data.data() + (pos - data_offset), size);
 			pos += size;
 			return true;
 		}
 
+		// Let the file handler store or release data which is no longer needed in memory
+		// Returns false if the file handler has failed (see m_failed)
+		bool breathe()
+		{
+			if (m_file_handler && !m_file_handler->handle_file_op(*this, pos, 0))
+			{
+				m_failed = true;
+			}
+
+			return !m_failed;
+		}
+
+		// Overwrite previously written data at the specified position
+		void patch_raw_data(usz at, const void* ptr, usz size)
+		{
+			if (at >= data_offset)
+			{
+				ensure(at - data_offset <= data.size() && data.size() - (at - data_offset) >= size);
+				std::memcpy(data.data() + (at - data_offset), ptr, size);
+				return;
+			}
+
+			ensure(m_file_handler && m_file_handler->patch(at, ptr, size));
+		}
+
+		// Get full data size
+		usz get_size() const
+		{
+			return m_file_handler ? m_file_handler->get_size(*this) : data_offset + data.size();
+		}
+
 		template <typename T> requires Integral<T>
 		bool serialize_vle(T&& value)
 		{
@@ -303,6 +372,7 @@ namespace utils
 			if (!_data.empty())
 			{
 				data = std::move(_data);
+				data_offset = 0;
 			}
 
 			m_is_writing = false;
@@ -313,17 +383,28 @@ namespace utils
 		void clear()
 		{
 			data.clear();
+			data_offset = 0;
+			m_file_handler.reset();
 			m_is_writing = true;
+			m_failed = false;
 			pos = 0;
 		}
 
 		usz seek_end(usz backwards = 0)
 		{
-			ensure(pos >= backwards);
-			pos = data.size() - backwards;
+			ensure(data.size() >= backwards);
+			pos = data_offset + data.size() - backwards;
 			return pos;
 		}
 
+		// Remove last bytes of data and seek to the end
+		usz trunc(usz count)
+		{
+			ensure(data.size() >= count);
+			data.resize(data.size() - count);
+			return seek_end();
+		}
+
 		template <typename T> requires (std::is_copy_constructible_v<std::remove_const_t<T>>) && (std::is_constructible_v<std::remove_const_t<T>> || Bitcopy<std::remove_const_t<T>> ||
 			std::is_constructible_v<std::remove_const_t<T>, stx::exact_t<serial&>> || TupleAlike<std::remove_const_t<T>>)
 		operator T()
@@ -364,10 +445,9 @@ namespace utils
 				return {};
 			}
 
-			const usz left = data.size() - pos;
-	 		using type = std::remove_const_t<T>;
+			using type = std::remove_const_t<T>;
 
-			if (left >= sizeof(type))
+			if (is_available(sizeof(type)) || (m_file_handler && m_file_handler->handle_file_op(*this, pos, sizeof(type)) && is_available(sizeof(type))))
 			{
 				u8 buf[sizeof(type)]{};
 				ensure(raw_serialize(buf, sizeof(buf)));
@@ -381,7 +461,7 @@ namespace utils
 		// Used when an invalid state is encountered somewhere in a place we can't check success code such as constructor)
 		bool is_valid() const
 		{
-			return pos <= data.size();
+			return pos <= get_size();
 		}
 	};
 }
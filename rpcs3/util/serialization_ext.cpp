@@ -0,0 +1,363 @@
+#include "stdafx.h"
+#include "util/serialization_ext.hpp"
+#include "util/sysinfo.hpp"
+#include "util/asm.hpp"
+
+#include <zlib.h>
+
+LOG_CHANNEL(sys_log, "SYS");
+
+namespace utils
+{
+	void compressed_serialization_file_handler::compression_worker::operator()()
+	{
+		for (auto slice = jobs.pop_all();; [&]
+		{
+			if (slice)
+			{
+				slice.pop_front();
+			}
+
+			if (slice || thread_ctrl::state() == thread_state::aborting)
+			{
+				return;
+			}
+
+			thread_ctrl::wait_on(jobs, nullptr);
+			slice = jobs.pop_all();
+		}())
+		{
+			auto* job = slice.get();
+
+			if (!job)
+			{
+				if (thread_ctrl::state() == thread_state::aborting)
+				{
+					break;
+				}
+
+				continue;
+			}
+
+			auto& [index, raw] = *job;
+
+			uLongf size = compressBound(static_cast<uLong>(raw.size()));
+			std::vector<u8> out(size);
+
+			if (compress2(out.data(), &size, raw.data(), static_cast<uLong>(raw.size()), 3) != Z_OK)
+			{
+				sys_log.error("Failed to compress serialization chunk %u", index);
+				handler->m_failed = true;
+			}
+			else
+			{
+				std::lock_guard lock(handler->m_mutex);
+
+				chunk_info& info = handler->m_index[index];
+				info.offset = handler->m_file_end;
+				info.size = static_cast<u32>(size);
+				info.raw_size = static_cast<u32>(raw.size());
+
+				if (handler->m_file.seek(handler->m_file_end), handler->m_file.write(out.data(), size) != size)
+				{
+					sys_log.error("Failed to write serialization chunk %u (%s)", index, fs::g_tls_error);
+					handler->m_failed = true;
+				}
+
+				handler->m_file_end += size;
+			}
+
+			// Release memory before notifying
+			raw = {};
+
+			handler->m_in_flight--;
+			handler->m_in_flight.notify_all();
+		}
+	}
+
+	compressed_serialization_file_handler::compressed_serialization_file_handler(const fs::file& file, bool is_writing)
+		: m_file(file)
+		, m_is_writing(is_writing)
+	{
+		if (!m_is_writing)
+		{
+			read_header();
+			return;
+		}
+
+		// Reserve space for the header
+		const file_header header{};
+
+		if (!m_file || !m_file.trunc(0) || m_file.write(&header, sizeof(header)) != sizeof(header))
+		{
+			m_failed = true;
+			return;
+		}
+
+		const u32 count = std::clamp<u32>(utils::get_thread_count() / 2, 1, 8);
+
+		for (u32 i = 0; i < count; i++)
+		{
+			m_workers.emplace_back(std::make_unique<named_thread<compression_worker>>(fmt::format("Serialization Compressor %u", i + 1), this));
+		}
+	}
+
+	compressed_serialization_file_handler::compressed_serialization_file_handler(fs::file&& file)
+		: m_file_storage(std::move(file))
+		, m_file(m_file_storage)
+		, m_is_writing(false)
+	{
+		read_header();
+	}
+
+	void compressed_serialization_file_handler::read_header()
+	{
+		file_header header{};
+
+		if (!m_file || (m_file.seek(0), !m_file.read(header)) || header.magic != c_magic || header.version != c_version || header.chunk_size != c_chunk_size)
+		{
+			m_failed = true;
+			return;
+		}
+
+		const u64 file_size = m_file.size();
+
+		if (header.index_offset < sizeof(header) || header.index_offset > file_size || (file_size - header.index_offset) / sizeof(chunk_info) < header.chunk_count ||
+			header.chunk_count != utils::aligned_div<u64>(header.raw_size, c_chunk_size))
+		{
+			m_failed = true;
+			return;
+		}
+
+		m_index.resize(header.chunk_count);
+		m_file.seek(header.index_offset);
+
+		if (!m_file.read(m_index.data(), m_index.size() * sizeof(chunk_info)))
+		{
+			m_failed = true;
+			return;
+		}
+
+		for (usz i = 0; i < m_index.size(); i++)
+		{
+			const chunk_info& info = m_index[i];
+
+			if (info.offset > file_size || file_size - info.offset < info.size || info.raw_size != std::min<u64>(c_chunk_size, header.raw_size - i * c_chunk_size))
+			{
+				m_failed = true;
+				return;
+			}
+		}
+
+		m_raw_size = header.raw_size;
+	}
+
+	compressed_serialization_file_handler::~compressed_serialization_file_handler()
+	{
+		// Stop workers (joins)
+		m_workers.clear();
+	}
+
+	void compressed_serialization_file_handler::submit(usz index, std::vector<u8>&& data)
+	{
+		{
+			std::lock_guard lock(m_mutex);
+
+			if (m_index.size() <= index)
+			{
+				m_index.resize(index + 1);
+			}
+		}
+
+		// Limit memory usage
+		for (u32 max = ::size32(m_workers) * 2, count = m_in_flight; count >= max; count = m_in_flight)
+		{
+			m_in_flight.wait(count);
+		}
+
+		m_in_flight++;
+		m_workers[index % m_workers.size()]->jobs.push(index, std::move(data));
+	}
+
+	bool compressed_serialization_file_handler::load_chunk(usz index, std::vector<u8>& out) const
+	{
+		if (index >= m_index.size())
+		{
+			return false;
+		}
+
+		const chunk_info& info = m_index[index];
+
+		std::vector<u8> compressed(info.size);
+
+		if (m_file.seek(info.offset), m_file.read(compressed.data(), compressed.size()) != compressed.size())
+		{
+			return false;
+		}
+
+		const usz old_size = out.size();
+		out.resize(old_size + info.raw_size);
+
+		uLongf size = info.raw_size;
+
+		if (uncompress(out.data() + old_size, &size, compressed.data(), static_cast<uLong>(compressed.size())) != Z_OK || size != info.raw_size)
+		{
+			sys_log.error("Failed to decompress serialization chunk %u", index);
+			out.resize(old_size);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool compressed_serialization_file_handler::handle_file_op(serial& ar, usz pos, usz size)
+	{
+		if (m_is_writing)
+		{
+			// Can only take data if it's not going to be modified
+			if (ar.pos != ar.data_offset + ar.data.size() || ar.data.size() < c_chunk_size)
+			{
+				return !m_failed;
+			}
+
+			const usz count = ar.data.size() / c_chunk_size;
+
+			for (usz i = 0; i < count; i++)
+			{
+				const usz index = ar.data_offset / c_chunk_size + i;
+				std::vector<u8> chunk(ar.data.begin() + i * c_chunk_size, ar.data.begin() + (i + 1) * c_chunk_size);
+
+				if (index == 0)
+				{
+					// Keep the first chunk for patching
+					m_head = std::move(chunk);
+					continue;
+				}
+
+				if (m_failed)
+				{
+					// The file is unusable, only release memory
+					continue;
+				}
+
+				submit(index, std::move(chunk));
+			}
+
+			ar.data.erase(ar.data.begin(), ar.data.begin() + count * c_chunk_size);
+			ar.data_offset += count * c_chunk_size;
+			return !m_failed;
+		}
+
+		if (m_failed)
+		{
+			return false;
+		}
+
+		if (pos > m_raw_size || m_raw_size - pos < size)
+		{
+			return false;
+		}
+
+		const usz first = pos / c_chunk_size * c_chunk_size;
+
+		if (pos < ar.data_offset || pos > ar.data_offset + ar.data.size())
+		{
+			// Restart from the chunk containing pos
+			ar.data.clear();
+			ar.data_offset = first;
+		}
+		else if (first > ar.data_offset)
+		{
+			// Release chunks which precede pos
+			ar.data.erase(ar.data.begin(), ar.data.begin() + (first - ar.data_offset));
+			ar.data_offset = first;
+		}
+
+		while (ar.data_offset + ar.data.size() < pos + size)
+		{
+			if (!load_chunk((ar.data_offset + ar.data.size()) / c_chunk_size, ar.data))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool compressed_serialization_file_handler::patch(usz pos, const void* ptr, usz size)
+	{
+		if (!m_is_writing || pos > m_head.size() || m_head.size() - pos < size)
+		{
+			return false;
+		}
+
+		std::memcpy(m_head.data() + pos, ptr, size);
+		return true;
+	}
+
+	bool compressed_serialization_file_handler::finalize(serial& ar)
+	{
+		if (!m_is_writing || m_failed)
+		{
+			return false;
+		}
+
+		m_raw_size = ar.data_offset + ar.data.size();
+
+		// Submit remaining data
+		for (usz i = 0; i < ar.data.size(); i += c_chunk_size)
+		{
+			submit((ar.data_offset + i) / c_chunk_size, std::vector<u8>(ar.data.begin() + i, ar.data.begin() + std::min(i + c_chunk_size, ar.data.size())));
+		}
+
+		if (!m_head.empty())
+		{
+			submit(0, std::move(m_head));
+		}
+
+		ar.data.clear();
+		ar.data_offset = m_raw_size;
+
+		// Wait for all jobs to complete, then stop workers
+		for (u32 count = m_in_flight; count; count = m_in_flight)
+		{
+			m_in_flight.wait(count);
+		}
+
+		m_workers.clear();
+
+		if (m_failed)
+		{
+			return false;
+		}
+
+		file_header header{};
+		header.magic = c_magic;
+		header.version = c_version;
+		header.chunk_size = c_chunk_size;
+		header.index_offset = m_file_end;
+		header.chunk_count = m_index.size();
+		header.raw_size = m_raw_size;
+
+		const usz index_size = m_index.size() * sizeof(chunk_info);
+
+		if (m_file.seek(m_file_end), m_file.write(m_index.data(), index_size) != index_size)
+		{
+			return false;
+		}
+
+		// Write header last
+		return (m_file.seek(0), m_file.write(&header, sizeof(header))) == sizeof(header);
+	}
+
+	usz compressed_serialization_file_handler::get_size(const serial& ar) const
+	{
+		return m_is_writing ? ar.data_offset + ar.data.size() : m_raw_size;
+	}
+
+	bool compressed_serialization_file_handler::is_compressed(const fs::file& file)
+	{
+		u64 magic = 0;
+		return file && file.size() >= sizeof(file_header) && (file.seek(0), file.read(magic)) && magic == c_magic;
+	}
+}
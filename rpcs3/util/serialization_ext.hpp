@@ -0,0 +1,102 @@
+#pragma once
+
+#include "util/serialization.hpp"
+#include "Utilities/File.h"
+#include "Utilities/Thread.h"
+#include "Utilities/lockless.h"
+#include "Utilities/mutex.h"
+
+namespace utils
+{
+	// Streaming zlib file backend for serial
+	// Data is split in fixed-size chunks which are compressed in parallel and written as soon as they are ready
+	// The first chunk is kept in memory until finalize() so the header can still be patched
+	class compressed_serialization_file_handler final : public serialization_file_handler
+	{
+	public:
+		static constexpr u64 c_magic = "RPCS3SVZ"_u64;
+		static constexpr u32 c_version = 1;
+		static constexpr usz c_chunk_size = 0x40'0000;
+
+		struct file_header
+		{
+			nse_t<u64, 1> magic;
+			le_t<u32> version;
+			le_t<u32> chunk_size;
+			le_t<u64> index_offset; // Chunk index position (written last)
+			le_t<u64> chunk_count;
+			le_t<u64> raw_size; // Size of uncompressed data
+		};
+
+		struct chunk_info
+		{
+			le_t<u64> offset;
+			le_t<u32> size; // Compressed size
+			le_t<u32> raw_size;
+		};
+
+	private:
+		struct compression_worker
+		{
+			compressed_serialization_file_handler* const handler;
+
+			// Chunk index and data
+			lf_queue<std::pair<usz, std::vector<u8>>> jobs;
+
+			compression_worker(compressed_serialization_file_handler* handler) noexcept
+				: handler(handler)
+			{
+			}
+
+			void operator()();
+		};
+
+		fs::file m_file_storage; // Owned file (reading)
+		const fs::file& m_file;
+		const bool m_is_writing;
+
+		// Chunk index (guarded by m_mutex when writing)
+		std::vector<chunk_info> m_index;
+		shared_mutex m_mutex;
+		u64 m_file_end = sizeof(file_header);
+		usz m_raw_size = 0;
+
+		// First chunk (writing)
+		std::vector<u8> m_head;
+
+		std::vector<std::unique_ptr<named_thread<compression_worker>>> m_workers;
+		atomic_t<u32> m_in_flight = 0;
+		atomic_t<bool> m_failed = false;
+
+		void read_header();
+		void submit(usz index, std::vector<u8>&& data);
+		bool load_chunk(usz index, std::vector<u8>& out) const;
+
+	public:
+		// The file must outlive the handler
+		explicit compressed_serialization_file_handler(const fs::file& file, bool is_writing = true);
+
+		// Reading mode, owns the file
+		explicit compressed_serialization_file_handler(fs::file&& file);
+
+		compressed_serialization_file_handler(const compressed_serialization_file_handler&) = delete;
+
+		compressed_serialization_file_handler& operator=(const compressed_serialization_file_handler&) = delete;
+
+		~compressed_serialization_file_handler() override;
+
+		// Check if the file header is valid for reading
+		explicit operator bool() const
+		{
+			return !m_failed;
+		}
+
+		bool handle_file_op(serial& ar, usz pos, usz size) override;
+		bool patch(usz pos, const void* ptr, usz size) override;
+		bool finalize(serial& ar) override;
+		usz get_size(const serial& ar) const override;
+
+		// Check whether the file uses this format
+		static bool is_compressed(const fs::file& file);
+	};
+}